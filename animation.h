@@ -0,0 +1,368 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+
+#include <gfx/gfx.h>
+
+namespace ui {
+
+enum class Easing { Linear, EaseIn, EaseOut, EaseInOut };
+
+// a duration of 0 disables the transition, so the property snaps to its target
+struct Transition {
+    float duration = 0.0f; // seconds
+    Easing easing = Easing::EaseOut;
+
+    [[nodiscard]] bool is_enabled() const {
+        return duration > 0.0f;
+    }
+};
+
+// Animated values are stored as separate float channels, so every channel of
+// every running animation can be interpolated by the same vectorizable loop.
+// Interpolation is linear per channel, like gfx::lerp().
+template <typename T>
+struct Channels;
+
+template <>
+struct Channels<float> {
+    static constexpr size_t count = 1;
+
+    static void split(float value, std::span<float, count> out) {
+        out[0] = value;
+    }
+
+    [[nodiscard]] static float join(std::span<const float, count> in) {
+        return in[0];
+    }
+};
+
+template <>
+struct Channels<gfx::Rect> {
+    static constexpr size_t count = 4;
+
+    static void split(const gfx::Rect& rect, std::span<float, count> out) {
+        out[0] = rect.x;
+        out[1] = rect.y;
+        out[2] = rect.width;
+        out[3] = rect.height;
+    }
+
+    [[nodiscard]] static gfx::Rect join(std::span<const float, count> in) {
+        return { in[0], in[1], in[2], in[3] };
+    }
+};
+
+template <>
+struct Channels<gfx::Color> {
+    static constexpr size_t count = 4;
+    using Component = decltype(gfx::Color::r);
+
+    static void split(const gfx::Color& color, std::span<float, count> out) {
+        out[0] = static_cast<float>(color.r);
+        out[1] = static_cast<float>(color.g);
+        out[2] = static_cast<float>(color.b);
+        out[3] = static_cast<float>(color.a);
+    }
+
+    [[nodiscard]] static gfx::Color join(std::span<const float, count> in) {
+        gfx::Color color = gfx::Color::black();
+        color.r = static_cast<Component>(in[0]);
+        color.g = static_cast<Component>(in[1]);
+        color.b = static_cast<Component>(in[2]);
+        color.a = static_cast<Component>(in[3]);
+        return color;
+    }
+};
+
+namespace detail {
+
+// every easing curve is expressed as the cubic polynomial a*t + b*t^2 + c*t^3,
+// so all curves can be evaluated by the same branchless loop
+struct EasingCurve {
+    float a, b, c;
+};
+
+[[nodiscard]] inline EasingCurve get_easing_curve(Easing easing) {
+    switch (easing) {
+        using enum Easing;
+        case Linear:    return { 1.0f,  0.0f,  0.0f }; // t
+        case EaseIn:    return { 0.0f,  0.0f,  1.0f }; // t^3
+        case EaseOut:   return { 3.0f, -3.0f,  1.0f }; // 1-(1-t)^3
+        case EaseInOut: return { 0.0f,  3.0f, -2.0f }; // 3t^2 - 2t^3
+    }
+    std::unreachable();
+}
+
+template <typename T> requires std::is_trivially_copyable_v<T>
+[[nodiscard]] bool bitwise_equal(const T& a, const T& b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+} // namespace detail
+
+// Stores all running animations of one value type in structure-of-arrays form.
+// Settled values are kept in a separate map, so only animations that are
+// actually in flight take part in the per-frame update.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class AnimationTrack {
+public:
+    AnimationTrack() = default;
+
+    // returns the value to display for `key` and starts a new animation if
+    // `target` differs from the last target seen for this key
+    [[nodiscard]] T track(Key key, T target, Transition transition, float now, uint64_t frame) {
+
+        if (auto it = m_active_index.find(key); it != m_active_index.end()) {
+            auto i = it->second;
+            m_frame[i] = frame;
+
+            if (not detail::bitwise_equal(get(m_to, i), target))
+                start(i, get(m_value, i), target, transition, now);
+
+            return get(m_value, i);
+        }
+
+        auto [it, inserted] = m_settled.try_emplace(key, Settled { target, frame });
+        auto& settled = it->second;
+        settled.frame = frame;
+
+        // first time we see this key, there is nothing to animate from
+        if (inserted or detail::bitwise_equal(settled.value, target))
+            return target;
+
+        T from = settled.value;
+        m_settled.erase(it);
+
+        auto i = push(key, frame);
+        start(i, from, target, transition, now);
+        return from;
+    }
+
+    // evaluates all running animations in a single pass
+    void update(float now) {
+        auto count = m_keys.size();
+        m_progress.resize(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            float t = std::clamp((now - m_start[i]) * m_inv_duration[i], 0.0f, 1.0f);
+            m_progress[i] = t * (m_curve_a[i] + t * (m_curve_b[i] + t * m_curve_c[i]));
+        }
+
+        for (size_t c = 0; c < ChannelCount; ++c) {
+            const float* from = m_from[c].data();
+            const float* to = m_to[c].data();
+            const float* progress = m_progress.data();
+            float* value = m_value[c].data();
+
+            for (size_t i = 0; i < count; ++i)
+                value[i] = from[i] + (to[i] - from[i]) * progress[i];
+        }
+
+        // retire finished animations
+        for (size_t i = count; i-- > 0;) {
+            if ((now - m_start[i]) * m_inv_duration[i] < 1.0f)
+                continue;
+
+            m_settled.insert_or_assign(m_keys[i], Settled { get(m_to, i), m_frame[i] });
+            remove(i);
+        }
+    }
+
+    // drops all values which have not been tracked during `frame`, as the
+    // widget they belong to is no longer part of the ui tree
+    void collect(uint64_t frame) {
+        for (size_t i = m_keys.size(); i-- > 0;) {
+            if (m_frame[i] != frame)
+                remove(i);
+        }
+
+        std::erase_if(m_settled, [&](const auto& entry) {
+            return entry.second.frame != frame;
+        });
+    }
+
+    [[nodiscard]] size_t active_count() const {
+        return m_keys.size();
+    }
+
+private:
+    static constexpr size_t ChannelCount = Channels<T>::count;
+    using ChannelArrays = std::array<std::vector<float>, ChannelCount>;
+
+    struct Settled {
+        T value;
+        uint64_t frame;
+    };
+
+    std::unordered_map<Key, size_t, Hash> m_active_index;
+    std::unordered_map<Key, Settled, Hash> m_settled;
+
+    std::vector<Key> m_keys;
+    std::vector<uint64_t> m_frame;
+    std::vector<float> m_start;
+    std::vector<float> m_inv_duration;
+    std::vector<float> m_curve_a;
+    std::vector<float> m_curve_b;
+    std::vector<float> m_curve_c;
+    std::vector<float> m_progress;
+    ChannelArrays m_from;
+    ChannelArrays m_to;
+    ChannelArrays m_value;
+
+    [[nodiscard]] static T get(const ChannelArrays& arrays, size_t i) {
+        std::array<float, ChannelCount> channels;
+        for (size_t c = 0; c < ChannelCount; ++c)
+            channels[c] = arrays[c][i];
+        return Channels<T>::join(channels);
+    }
+
+    static void set(ChannelArrays& arrays, size_t i, const T& value) {
+        std::array<float, ChannelCount> channels;
+        Channels<T>::split(value, channels);
+        for (size_t c = 0; c < ChannelCount; ++c)
+            arrays[c][i] = channels[c];
+    }
+
+    [[nodiscard]] size_t push(Key key, uint64_t frame) {
+        auto i = m_keys.size();
+        m_active_index[key] = i;
+        m_keys.push_back(key);
+        m_frame.push_back(frame);
+        m_start.push_back(0.0f);
+        m_inv_duration.push_back(0.0f);
+        m_curve_a.push_back(0.0f);
+        m_curve_b.push_back(0.0f);
+        m_curve_c.push_back(0.0f);
+        for (size_t c = 0; c < ChannelCount; ++c) {
+            m_from[c].push_back(0.0f);
+            m_to[c].push_back(0.0f);
+            m_value[c].push_back(0.0f);
+        }
+        return i;
+    }
+
+    void start(size_t i, T from, T to, Transition transition, float now) {
+        auto curve = detail::get_easing_curve(transition.easing);
+        m_start[i] = now;
+        m_inv_duration[i] = 1.0f / transition.duration;
+        m_curve_a[i] = curve.a;
+        m_curve_b[i] = curve.b;
+        m_curve_c[i] = curve.c;
+        set(m_from, i, from);
+        set(m_to, i, to);
+        set(m_value, i, from);
+    }
+
+    // swap-remove, so the arrays stay densely packed
+    void remove(size_t i) {
+        auto last = m_keys.size() - 1;
+        m_active_index.erase(m_keys[i]);
+
+        if (i != last) {
+            m_keys[i]         = m_keys[last];
+            m_frame[i]        = m_frame[last];
+            m_start[i]        = m_start[last];
+            m_inv_duration[i] = m_inv_duration[last];
+            m_curve_a[i]      = m_curve_a[last];
+            m_curve_b[i]      = m_curve_b[last];
+            m_curve_c[i]      = m_curve_c[last];
+            for (size_t c = 0; c < ChannelCount; ++c) {
+                m_from[c][i]  = m_from[c][last];
+                m_to[c][i]    = m_to[c][last];
+                m_value[c][i] = m_value[c][last];
+            }
+            m_active_index[m_keys[i]] = i;
+        }
+
+        m_keys.pop_back();
+        m_frame.pop_back();
+        m_start.pop_back();
+        m_inv_duration.pop_back();
+        m_curve_a.pop_back();
+        m_curve_b.pop_back();
+        m_curve_c.pop_back();
+        for (size_t c = 0; c < ChannelCount; ++c) {
+            m_from[c].pop_back();
+            m_to[c].pop_back();
+            m_value[c].pop_back();
+        }
+    }
+
+};
+
+// Owns the transitions of all widgets of a Ui. Widgets only call into the
+// animator if their style has a transition enabled, so static widgets are free.
+class Animator {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Id = uint64_t;
+
+    enum class Property { Rect, Color, BorderRadius };
+
+    struct Key {
+        Id id;
+        Property property;
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<Id>{}(key.id) ^ (static_cast<size_t>(key.property) << 61);
+        }
+    };
+
+    Animator() = default;
+
+    // advances all running animations to the current time, call once per frame
+    // before any widget tracks its properties
+    void update() {
+        m_now = std::chrono::duration<float>(Clock::now() - m_epoch).count();
+        m_frame++;
+        m_rects.update(m_now);
+        m_colors.update(m_now);
+        m_floats.update(m_now);
+    }
+
+    // forgets about widgets that were not part of the last frame
+    void collect() {
+        m_rects.collect(m_frame);
+        m_colors.collect(m_frame);
+        m_floats.collect(m_frame);
+    }
+
+    [[nodiscard]] gfx::Rect track(Id id, gfx::Rect target, Transition transition) {
+        return m_rects.track({ id, Property::Rect }, target, transition, m_now, m_frame);
+    }
+
+    [[nodiscard]] gfx::Color track(Id id, gfx::Color target, Transition transition) {
+        return m_colors.track({ id, Property::Color }, target, transition, m_now, m_frame);
+    }
+
+    [[nodiscard]] float track(Id id, Property property, float target, Transition transition) {
+        return m_floats.track({ id, property }, target, transition, m_now, m_frame);
+    }
+
+    [[nodiscard]] size_t active_count() const {
+        return m_rects.active_count() + m_colors.active_count() + m_floats.active_count();
+    }
+
+private:
+    const Clock::time_point m_epoch = Clock::now();
+    float m_now = 0.0f;
+    uint64_t m_frame = 0;
+
+    AnimationTrack<Key, gfx::Rect, KeyHash> m_rects;
+    AnimationTrack<Key, gfx::Color, KeyHash> m_colors;
+    AnimationTrack<Key, float, KeyHash> m_floats;
+
+};
+
+} // namespace ui
@@ -3,6 +3,9 @@
 #include <any>
 #include <gfx/gfx.h>
 #include "style.h"
+#include "animation.h"
+#include "clip.h"
+#include "input.h"
 
 namespace ui {
 
@@ -16,6 +19,9 @@ public:
         , m_window(window)
         , m_style(style)
         , m_rect(position.x, position.y, width, height)
+        , m_visual_rect(m_rect)
+        , m_visual_color(m_style.color_bg)
+        , m_visual_border_radius(m_style.border_radius)
     { }
 
     virtual ~Box() = default;
@@ -36,6 +42,40 @@ public:
         return m_rect;
     }
 
+    // the rect the element is drawn at, which might be in the middle of a transition
+    [[nodiscard]] const gfx::Rect& get_visual_rect() const {
+        return m_visual_rect;
+    }
+
+    [[nodiscard]] gfx::Color get_visual_color() const {
+        return m_visual_color;
+    }
+
+    // the region of the screen this element may draw into
+    [[nodiscard]] const gfx::Rect& get_clip_rect() const {
+        return m_clip_rect;
+    }
+
+    void set_clip_rect(gfx::Rect clip) {
+        m_clip_rect = clip;
+    }
+
+    // invisible elements are neither drawn, nor do they receive any input
+    [[nodiscard]] bool is_visible() const {
+        return overlaps(m_rect, m_clip_rect);
+    }
+
+    // the offset of all scroll containers this element is in. it is excluded
+    // from rect transitions, so scrolling does not animate the content.
+    void set_scroll_offset(gfx::Vec offset) {
+        m_scroll_offset = offset;
+    }
+
+    // the input snapshot the element reacts to, has to be set before handle_input()
+    void set_input(const Input& input) {
+        m_input = &input;
+    }
+
     [[nodiscard]] bool is_debug_selected() const {
         return m_is_debug_selected;
     }
@@ -48,25 +88,70 @@ public:
 
     virtual void for_each_child([[maybe_unused]] std::function<void(Box&)> fn) const { }
 
+    // skips whole subtrees which are outside of the clip rect
+    virtual void for_each_visible_child(std::function<void(Box&)> fn) const {
+        for_each_child([&](Box& child) {
+            if (child.is_visible())
+                fn(child);
+        });
+    }
+
     virtual void handle_input() { }
 
+    // called on the render thread once the tree has been built, before it is
+    // drawn for the first time. callbacks are registered with the window here,
+    // as the tree might be built on another thread.
+    virtual void attach() { }
+
+    // whether a mouse press at the current pointer position is meant for this
+    // element, eg: so that pressing a button does not also scroll its parent
+    [[nodiscard]] virtual bool captures_mouse() const {
+        return false;
+    }
+
+    // updates the visual state of the element with input which has been
+    // sampled again right before drawing. unlike handle_input(), this must not
+    // have any effects visible to the user of the library.
+    virtual void latch_input([[maybe_unused]] const Input& input) { }
+
+    // resolves the values used for drawing, which might be in the middle of a
+    // transition. must be called after layout and before draw().
+    void animate(Animator& animator) {
+        m_visual_rect = m_rect;
+        m_visual_color = get_color();
+        m_visual_border_radius = m_style.border_radius;
+
+        const auto& transition = m_style.transition;
+        if (not transition.is_enabled()) return;
+
+        gfx::Rect content_rect = m_rect;
+        content_rect.x += m_scroll_offset.x;
+        content_rect.y += m_scroll_offset.y;
+
+        m_visual_rect = animator.track(m_id, content_rect, transition);
+        m_visual_rect.x -= m_scroll_offset.x;
+        m_visual_rect.y -= m_scroll_offset.y;
+
+        m_visual_color = animator.track(m_id, m_visual_color, transition);
+        m_visual_border_radius = animator.track(m_id, Animator::Property::BorderRadius, m_visual_border_radius, transition);
+    }
+
     virtual void draw(gfx::Renderer& rd) const {
         auto color = m_is_debug_selected
-            ? gfx::lerp(m_style.color_bg, gfx::Color::white(), 0.75f)
-            : m_style.color_bg;
+            ? gfx::lerp(m_visual_color, gfx::Color::white(), 0.75f)
+            : m_visual_color;
 
         // draw_rectangle_rounded() actually draws 4 circles and 2 rectangles,
         // which might impact performance, even when the border radius is 0.
-        if (m_style.border_radius == 0.0f)
-            rd.draw_rectangle(m_rect, color);
+        if (m_visual_border_radius == 0.0f)
+            rd.draw_rectangle(m_visual_rect, color);
         else
-            rd.draw_rectangle_rounded(m_rect, color, m_style.border_radius);
+            rd.draw_rectangle_rounded(m_visual_rect, color, m_visual_border_radius);
     }
 
     // returns whether the current element is selected by the cursor
     virtual bool debug() {
-        auto mouse = m_window.get_mouse_pos();
-        return m_is_debug_selected = m_rect.check_collision_point(mouse);
+        return m_is_debug_selected = is_hovered();
     }
 
     [[nodiscard]] virtual std::string format() const {
@@ -79,6 +164,28 @@ protected:
     const Style m_style;
     bool m_is_debug_selected = false;
     gfx::Rect m_rect;
+    gfx::Rect m_clip_rect = unbounded_rect();
+    gfx::Vec m_scroll_offset = gfx::Vec::zero();
+    const Input* m_input = nullptr;
+
+    gfx::Rect m_visual_rect;
+    gfx::Color m_visual_color;
+    float m_visual_border_radius;
+
+    // only the visible part of an element can be hovered
+    [[nodiscard]] bool is_hovered(const Input& input) const {
+        auto mouse = input.get_mouse_pos();
+        return m_rect.check_collision_point(mouse) and m_clip_rect.check_collision_point(mouse);
+    }
+
+    [[nodiscard]] bool is_hovered() const {
+        return is_hovered(*m_input);
+    }
+
+    // the background color the element should currently have
+    [[nodiscard]] virtual gfx::Color get_color() const {
+        return m_style.color_bg;
+    }
 
 };
 
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <condition_variable>
+
+namespace ui {
+
+// A persistent thread which builds the tree of the next frame, while the
+// render thread draws the previous one. Work which has to happen on the
+// render thread, eg: loading fonts, is handed back by the build with
+// run_on_render_thread(), and executed while the render thread waits for the
+// build to finish.
+//
+// The worker has to be created on the render thread.
+class BuildWorker {
+public:
+    BuildWorker()
+        : m_render_thread(std::this_thread::get_id())
+        , m_thread(std::bind_front(&BuildWorker::worker, this))
+    { }
+
+    BuildWorker(const BuildWorker&) = delete;
+    BuildWorker(BuildWorker&&) = delete;
+    BuildWorker& operator=(const BuildWorker&) = delete;
+    BuildWorker& operator=(BuildWorker&&) = delete;
+
+    // hands the next job to the worker, the previous one must have been waited for
+    void start(std::function<void()> job) {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_job = std::move(job);
+            m_is_done = false;
+        }
+
+        m_cv.notify_all();
+    }
+
+    // blocks until the job has finished, running tasks posted by the job in
+    // the meantime. exceptions thrown by the job are rethrown here.
+    void wait() {
+        std::unique_lock lock(m_mutex);
+
+        while (true) {
+            m_cv.wait(lock, [&] { return m_is_done or m_task != nullptr; });
+            if (m_task == nullptr) break;
+
+            auto& task = *m_task;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            m_task = nullptr;
+            m_task_error = error;
+            m_cv.notify_all();
+        }
+
+        if (auto error = std::exchange(m_error, nullptr))
+            std::rethrow_exception(error);
+    }
+
+    // blocks the job until fn has been run by the render thread. when called
+    // on the render thread itself, fn is invoked directly.
+    void run_on_render_thread(const std::function<void()>& fn) {
+        if (std::this_thread::get_id() == m_render_thread) {
+            fn();
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_task = &fn;
+        m_cv.notify_all();
+
+        if (not m_cv.wait(lock, m_thread.get_stop_token(), [&] { return m_task == nullptr; }))
+            throw std::runtime_error("build worker stopped while waiting for the render thread");
+
+        if (auto error = std::exchange(m_task_error, nullptr))
+            std::rethrow_exception(error);
+    }
+
+private:
+    const std::thread::id m_render_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_cv;
+    std::function<void()> m_job;
+    bool m_is_done = true;
+    std::exception_ptr m_error;
+
+    // a task posted by the job, which the render thread runs in wait()
+    const std::function<void()>* m_task = nullptr;
+    std::exception_ptr m_task_error;
+
+    // declared last, so it is stopped before the members above are destroyed
+    std::jthread m_thread;
+
+    void worker(std::stop_token stop) {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_mutex);
+                if (not m_cv.wait(lock, stop, [&] { return m_job != nullptr; }))
+                    return;
+
+                job = std::exchange(m_job, nullptr);
+            }
+
+            std::exception_ptr error;
+            try {
+                job();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::scoped_lock lock(m_mutex);
+                m_error = error;
+                m_is_done = true;
+            }
+
+            m_cv.notify_all();
+        }
+    }
+
+};
+
+} // namespace ui
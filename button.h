@@ -9,9 +9,9 @@ namespace ui {
 
 class Button : public Label, public Clickable {
 public:
-    Button(Id id, gfx::Window& window, gfx::Vec position, Style style, std::string_view text, const gfx::Font& font)
+    Button(Id id, gfx::Window& window, gfx::Vec position, Style style, std::string_view text, const gfx::Font& font, int text_width)
         : Box(id, window, position, style, 0, 0)
-        , Label(id, window, position, style, text, font)
+        , Label(id, window, position, style, text, font, text_width)
         , Clickable(id, window, position, style, 0, 0)
     { }
 
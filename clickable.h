@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include <gfx/gfx.h>
 
 #include "box.h"
@@ -43,50 +45,59 @@ public:
     }
 
     void handle_input() override {
+        m_state = compute_state(*m_input);
+    }
 
-        auto mouse = m_window.get_mouse_pos();
-        bool is_selected = m_rect.check_collision_point(mouse);
+    [[nodiscard]] bool captures_mouse() const override {
+        return is_hovered();
+    }
 
-        if (not is_selected) {
-            m_state = ClickState::Idle;
-            return;
-        }
+    // the state returned by get_state() has already been handed out, so only
+    // the drawn state is updated
+    void latch_input(const Input& input) override {
+        m_drawn_state = compute_state(input);
+    }
+
+    void draw(gfx::Renderer& rd) const override {
+        rd.draw_rectangle_rounded(m_visual_rect, m_visual_color, m_visual_border_radius);
+    }
+
+    [[nodiscard]] std::string format() const override;
+
+protected:
+    ClickState m_state = ClickState::Idle;
+    std::optional<ClickState> m_drawn_state;
+
+    [[nodiscard]] ClickState compute_state(const Input& input) const {
 
-        auto state = m_window.get_mouse_button_state(gfx::MouseButton::Left);
+        if (not is_hovered(input))
+            return ClickState::Idle;
+
+        auto state = input.get_mouse_left();
         bool is_pressed = state.is_pressed();
         bool is_clicked = state.is_clicked();
 
         if (is_clicked)
-            m_state = ClickState::Clicked;
+            return ClickState::Clicked;
 
         else if (is_pressed)
-            m_state = ClickState::Pressed;
+            return ClickState::Pressed;
 
         else
-            m_state = ClickState::Hovered;
+            return ClickState::Hovered;
     }
 
-    void draw(gfx::Renderer& rd) const override {
-
-        auto color = [&] {
-            switch (m_state) {
-                using enum ClickState;
-                case Idle:    return m_style.color_bg;
-                case Hovered: return m_style.color_hover;
-                case Clicked:
-                case Pressed: return m_style.color_press;
-            }
-            std::unreachable();
-        }();
-
-        rd.draw_rectangle_rounded(m_rect, color, m_style.border_radius);
+    [[nodiscard]] gfx::Color get_color() const override {
+        switch (m_drawn_state.value_or(m_state)) {
+            using enum ClickState;
+            case Idle:    return m_style.color_bg;
+            case Hovered: return m_style.color_hover;
+            case Clicked:
+            case Pressed: return m_style.color_press;
+        }
+        std::unreachable();
     }
 
-    [[nodiscard]] std::string format() const override;
-
-protected:
-    ClickState m_state = ClickState::Idle;
-
 };
 
 } // namespace ui
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <limits>
+#include <algorithm>
+
+#include <gfx/gfx.h>
+
+namespace ui {
+
+// the clip rect of elements which are not inside of any scroll container
+[[nodiscard]] inline gfx::Rect unbounded_rect() {
+    constexpr float max = std::numeric_limits<float>::max() / 2.0f;
+    return { -max / 2.0f, -max / 2.0f, max, max };
+}
+
+[[nodiscard]] inline bool is_bounded(const gfx::Rect& rect) {
+    return rect.width < unbounded_rect().width;
+}
+
+[[nodiscard]] inline bool overlaps(const gfx::Rect& a, const gfx::Rect& b) {
+    return a.x < b.x + b.width
+        and b.x < a.x + a.width
+        and a.y < b.y + b.height
+        and b.y < a.y + a.height;
+}
+
+// returns an empty rect if a and b do not overlap
+[[nodiscard]] inline gfx::Rect intersect(const gfx::Rect& a, const gfx::Rect& b) {
+    float x = std::max(a.x, b.x);
+    float y = std::max(a.y, b.y);
+    float width = std::min(a.x + a.width, b.x + b.width) - x;
+    float height = std::min(a.y + a.height, b.y + b.height) - y;
+    return { x, y, std::max(width, 0.0f), std::max(height, 0.0f) };
+}
+
+} // namespace ui
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include <gfx/gfx.h>
 
 #include "box.h"
@@ -48,12 +50,25 @@ public:
         }
     }
 
+    void for_each_visible_child(std::function<void(Box&)> fn) const override {
+        for (auto& child : get_visible_range()) {
+            if (child->is_visible())
+                fn(*child);
+        }
+    }
+
     [[nodiscard]] std::string format() const override;
 
+    [[nodiscard]] bool captures_mouse() const override {
+        return ranges::any_of(get_visible_range(), [&](const std::unique_ptr<Box>& child) {
+            return child->is_visible() and child->captures_mouse();
+        });
+    }
+
     bool debug() override {
 
-        bool found = ranges::any_of(m_children, [&](const std::unique_ptr<Box>& child) {
-            return child->debug();
+        bool found = ranges::any_of(get_visible_range(), [&](const std::unique_ptr<Box>& child) {
+            return child->is_visible() and child->debug();
         });
 
         if (not found)
@@ -65,9 +80,7 @@ public:
     void draw(gfx::Renderer& rd) const override {
         Box::draw(rd);
 
-        for (const auto& child : m_children) {
-            child->draw(rd);
-        }
+        draw_children(rd);
     }
 
 protected:
@@ -77,6 +90,22 @@ protected:
     float gfx::Rect::* m_moving_side;
     float gfx::Rect::* m_static_side;
 
+    using ChildRange = std::span<const std::unique_ptr<Box>>;
+
+    // the children which might be visible, every child in the range still has
+    // to be checked with is_visible()
+    [[nodiscard]] virtual ChildRange get_visible_range() const {
+        return m_children;
+    }
+
+    // whole subtrees outside of the clip rect are skipped
+    void draw_children(gfx::Renderer& rd) const {
+        for (const auto& child : get_visible_range()) {
+            if (child->is_visible())
+                child->draw(rd);
+        }
+    }
+
     void compute_static_side() {
         auto largest_static_side = ranges::max_element(m_children, [&](const std::unique_ptr<Box>& a, decltype(a) b) {
             auto get_size = [&](decltype(a) child) {
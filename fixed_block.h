@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+#include <cassert>
+
+#include <gfx/gfx.h>
+
+#include "box.h"
+#include "style.h"
+#include "fixed_layout.h"
+
+namespace ui {
+
+// Draws a subtree which has been laid out at compile time, see fixed_layout.h.
+// The block does not own its commands, so they have to outlive the frame.
+class FixedBlock : public Box {
+public:
+    FixedBlock(Id id, gfx::Window& window, gfx::Vec position, Style style, std::span<const fixed::Command> commands, std::span<const gfx::Color> palette)
+        : Box(id, window, position, style, commands.front().width, commands.front().height)
+        , m_commands(commands)
+        , m_palette(palette)
+    { }
+
+    void draw(gfx::Renderer& rd) const override {
+        // the commands already include the margin of the root element
+        float origin_x = m_visual_rect.x - m_style.margin;
+        float origin_y = m_visual_rect.y - m_style.margin;
+
+        for (const auto& cmd : m_commands) {
+            assert(cmd.color < m_palette.size());
+
+            gfx::Rect rect(origin_x + cmd.x, origin_y + cmd.y, cmd.width, cmd.height);
+            auto color = m_palette[cmd.color];
+
+            // the whole block is highlighted, as its elements cannot be selected
+            if (m_is_debug_selected and &cmd == &m_commands.front())
+                color = gfx::lerp(color, gfx::Color::white(), 0.75f);
+
+            if (cmd.border_radius == 0.0f)
+                rd.draw_rectangle(rect, color);
+            else
+                rd.draw_rectangle_rounded(rect, color, cmd.border_radius);
+        }
+    }
+
+    [[nodiscard]] std::string format() const override {
+        return std::format("FixedBlock ({} commands)", m_commands.size());
+    }
+
+protected:
+    const std::span<const fixed::Command> m_commands;
+    const std::span<const gfx::Color> m_palette;
+
+};
+
+} // namespace ui
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace ui::fixed {
+
+// Describes static subtrees made of fixed-size elements, which are laid out
+// entirely at compile time. The layout rules are the same as the ones of
+// Ui::box(), Ui::horizontal() and Ui::vertical(), so the following produce
+// the same rects:
+//
+//   static constexpr auto toolbar = fixed::horizontal({ .padding=5 },
+//       fixed::box(40, 40, { .color=1 }),
+//       fixed::box(40, 40, { .margin=5, .color=2 })
+//   );
+//   ui.fixed_block(toolbar, palette);
+//
+//   ui.horizontal([&] {
+//       ui.box(40, 40, ...);
+//       ui.box(40, 40, { .margin=5, ... });
+//   }, { .padding=5 });
+//
+// Colors are not known at compile time, they refer to an index into the
+// palette which is passed to Ui::fixed_block().
+
+struct Style {
+    float margin = 0.0f;
+    float padding = 0.0f;
+    float border_radius = 0.0f;
+    size_t color = 0;
+};
+
+// rect of a single element, relative to the position of the block
+struct Command {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float border_radius = 0.0f;
+    size_t color = 0;
+};
+
+// the first command always belongs to the root element of the layout
+template <size_t N>
+struct Layout {
+    std::array<Command, N> commands;
+    float margin = 0.0f;
+
+    [[nodiscard]] constexpr const Command& root() const {
+        return commands.front();
+    }
+};
+
+enum class Direction { Horizontal, Vertical };
+
+[[nodiscard]] constexpr Layout<1> box(float width, float height, Style style={}) {
+    return {
+        { Command { style.margin, style.margin, width, height, style.border_radius, style.color } },
+        style.margin,
+    };
+}
+
+namespace detail {
+
+template <size_t... Ns>
+[[nodiscard]] constexpr auto container(Direction direction, Style style, const Layout<Ns>&... children) -> Layout<1 + (Ns + ... + 0)> {
+    static_assert(sizeof...(children) > 0, "containers need at least one child");
+
+    Layout<1 + (Ns + ... + 0)> layout {};
+    layout.margin = style.margin;
+
+    auto moving_side = [&](const Command& cmd) {
+        return direction == Direction::Horizontal ? cmd.width : cmd.height;
+    };
+
+    auto static_side = [&](const Command& cmd) {
+        return direction == Direction::Horizontal ? cmd.height : cmd.width;
+    };
+
+    // same as Container::compute_static_side(): the largest child is selected
+    // including one margin, but its size includes both margins
+    float largest_size = 0.0f;
+    float largest_static_side = 0.0f;
+    float child_sum = 0.0f;
+    bool is_first = true;
+
+    auto measure = [&](const auto& child) {
+        float size = static_side(child.root()) + child.margin;
+        if (is_first or largest_size < size) {
+            largest_size = size;
+            largest_static_side = static_side(child.root()) + child.margin * 2.0f;
+            is_first = false;
+        }
+        child_sum += moving_side(child.root()) + child.margin * 2.0f;
+    };
+    (measure(children), ...);
+
+    float width = child_sum + style.padding * 2.0f;
+    float height = largest_static_side + style.padding * 2.0f;
+    if (direction == Direction::Vertical)
+        std::swap(width, height);
+
+    layout.commands[0] = { style.margin, style.margin, width, height, style.border_radius, style.color };
+
+    // same as Ui::container(): children start at the padding, without the
+    // margin of the container
+    float axis_x = style.padding;
+    float axis_y = style.padding;
+    size_t index = 1;
+
+    auto place = [&](const auto& child) {
+        for (auto cmd : child.commands) {
+            cmd.x += axis_x;
+            cmd.y += axis_y;
+            layout.commands[index++] = cmd;
+        }
+
+        if (direction == Direction::Horizontal)
+            axis_x += child.root().width + child.margin * 2.0f;
+        else
+            axis_y += child.root().height + child.margin * 2.0f;
+    };
+    (place(children), ...);
+
+    return layout;
+}
+
+} // namespace detail
+
+template <size_t... Ns>
+[[nodiscard]] constexpr auto horizontal(Style style, const Layout<Ns>&... children) {
+    return detail::container(Direction::Horizontal, style, children...);
+}
+
+template <size_t... Ns>
+[[nodiscard]] constexpr auto vertical(Style style, const Layout<Ns>&... children) {
+    return detail::container(Direction::Vertical, style, children...);
+}
+
+} // namespace ui::fixed
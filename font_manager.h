@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include <format>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+#include <gfx/gfx.h>
+
+namespace ui {
+
+// Process-wide registry of fonts, shared by all Ui instances. The system font
+// directories are only scanned on the first request, and every font is loaded
+// at most once per process. The glyph atlas of a font is owned by gfx::Font,
+// which rasterizes glyphs for every size it is drawn at, so all Ui instances
+// and windows share it. Fonts are destroyed together with the last Ui.
+//
+// Like the textures of the ImageCache, fonts are assumed to be usable by every
+// window, as gfx shares one graphics context between them.
+class FontManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // overrides font discovery with a path to a font file
+    static constexpr const char* env_font = "LIBUI_FONT";
+
+    // tried in order, the first one found on the system is the default font
+    static constexpr std::array preferred_fonts {
+        "FiraCodeNerdFont-Regular.ttf",
+        "FiraCode-Regular.ttf",
+        "DejaVuSansMono.ttf",
+        "DejaVuSans.ttf",
+        "LiberationMono-Regular.ttf",
+        "LiberationSans-Regular.ttf",
+        "NotoSans-Regular.ttf",
+        "consola.ttf",
+        "arial.ttf",
+        "Menlo.ttc",
+    };
+
+    struct Stats {
+        Clock::duration discovery_time {};
+        Clock::duration load_time {};
+        size_t discovered_fonts = 0;
+        size_t loaded_fonts = 0;
+        // size of the loaded font files. the memory of the glyph atlases is
+        // owned by gfx::Font, which does not expose it, so it is not reported.
+        size_t font_file_bytes = 0;
+    };
+
+    static FontManager& get() {
+        static FontManager instance;
+        return instance;
+    }
+
+    FontManager(const FontManager&) = delete;
+    FontManager(FontManager&&) = delete;
+    FontManager& operator=(const FontManager&) = delete;
+    FontManager& operator=(FontManager&&) = delete;
+
+    // the default font, loaded on first use. the window is only needed for
+    // loading, the font can be used with every window afterwards.
+    [[nodiscard]] const gfx::Font& get_default_font(gfx::Window& window) {
+        std::scoped_lock lock(m_mutex);
+
+        if (m_default_font.empty())
+            m_default_font = find_default_font();
+
+        return load(window, m_default_font);
+    }
+
+    // looks up a font by its filename, eg: "DejaVuSans.ttf"
+    [[nodiscard]] const gfx::Font& get_font(gfx::Window& window, std::string_view name) {
+        std::scoped_lock lock(m_mutex);
+        discover();
+
+        auto it = m_available.find(std::string(name));
+        if (it == m_available.end())
+            throw std::runtime_error(std::format("font not found: {}", name));
+
+        return load(window, it->second);
+    }
+
+    // every Ui holds a reference to the fonts. once the last one is released,
+    // all fonts are destroyed, so they never outlive the graphics context.
+    void acquire() {
+        std::scoped_lock lock(m_mutex);
+        m_users++;
+    }
+
+    void release() {
+        std::scoped_lock lock(m_mutex);
+
+        assert(m_users > 0);
+        if (--m_users == 0)
+            m_loaded.clear();
+    }
+
+    [[nodiscard]] Stats get_stats() const {
+        std::scoped_lock lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    bool m_is_discovered = false;
+    std::filesystem::path m_default_font;
+    std::unordered_map<std::string, std::filesystem::path> m_available;
+    // references handed out to widgets must stay valid
+    std::unordered_map<std::filesystem::path, std::unique_ptr<gfx::Font>> m_loaded;
+    size_t m_users = 0;
+    Stats m_stats;
+
+    FontManager() = default;
+
+    [[nodiscard]] const gfx::Font& load(gfx::Window& window, const std::filesystem::path& path) {
+        if (auto it = m_loaded.find(path); it != m_loaded.end())
+            return *it->second;
+
+        auto start = Clock::now();
+        // constructed in place, as gfx::Font might not be movable
+        std::unique_ptr<gfx::Font> font(new gfx::Font(window.load_font(path.string().c_str())));
+        m_stats.load_time += Clock::now() - start;
+
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        m_stats.font_file_bytes += error ? 0 : size;
+        m_stats.loaded_fonts++;
+
+        return *m_loaded.emplace(path, std::move(font)).first->second;
+    }
+
+    void discover() {
+        if (m_is_discovered) return;
+        m_is_discovered = true;
+
+        auto start = Clock::now();
+
+        for (const auto& dir : get_font_dirs())
+            scan(dir);
+
+        m_stats.discovered_fonts = m_available.size();
+        m_stats.discovery_time = Clock::now() - start;
+    }
+
+    void scan(const std::filesystem::path& dir) {
+        namespace fs = std::filesystem;
+
+        std::error_code error;
+        auto options = fs::directory_options::skip_permission_denied;
+
+        for (fs::recursive_directory_iterator it(dir, options, error), end; not error and it != end; it.increment(error)) {
+            if (not it->is_regular_file(error)) continue;
+
+            auto ext = it->path().extension();
+            if (ext != ".ttf" and ext != ".otf" and ext != ".ttc") continue;
+
+            // the first occurrence wins, font dirs are scanned by priority
+            m_available.try_emplace(it->path().filename().string(), it->path());
+        }
+    }
+
+    // setting the environment variable skips scanning the font directories
+    [[nodiscard]] std::filesystem::path find_default_font() {
+        if (auto env = std::getenv(env_font); env != nullptr)
+            return env;
+
+        discover();
+
+        for (auto name : preferred_fonts) {
+            if (auto it = m_available.find(name); it != m_available.end())
+                return it->second;
+        }
+
+        if (not m_available.empty())
+            return m_available.begin()->second;
+
+        throw std::runtime_error(std::format("no font found, set {} to the path of a font", env_font));
+    }
+
+    [[nodiscard]] static std::vector<std::filesystem::path> get_font_dirs() {
+        std::vector<std::filesystem::path> dirs;
+
+        if (auto home = std::getenv("HOME"); home != nullptr) {
+            dirs.emplace_back(std::filesystem::path(home) / ".local/share/fonts");
+            dirs.emplace_back(std::filesystem::path(home) / ".fonts");
+            dirs.emplace_back(std::filesystem::path(home) / "Library/Fonts");
+        }
+
+        if (auto windir = std::getenv("WINDIR"); windir != nullptr)
+            dirs.emplace_back(std::filesystem::path(windir) / "Fonts");
+
+        dirs.emplace_back("/usr/share/fonts");
+        dirs.emplace_back("/usr/local/share/fonts");
+        dirs.emplace_back("/System/Library/Fonts");
+        dirs.emplace_back("/Library/Fonts");
+
+        return dirs;
+    }
+
+};
+
+} // namespace ui
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <variant>
+#include <filesystem>
+
+#include <gfx/gfx.h>
+
+#include "box.h"
+#include "style.h"
+#include "image_cache.h"
+
+namespace ui {
+
+class Image : public Box {
+public:
+    using Source = std::variant<std::filesystem::path, EncodedImage>;
+
+    Image(Id id, gfx::Window& window, gfx::Vec position, Style style, Source source, float width, float height)
+        : Box(id, window, position, style, width, height)
+        , m_source(std::move(source))
+    { }
+
+    // the style's background is drawn as a placeholder until the image is decoded
+    void draw(gfx::Renderer& rd) const override {
+        auto width = static_cast<int>(m_rect.width);
+        auto height = static_cast<int>(m_rect.height);
+
+        auto texture = std::visit([&](const auto& source) {
+            return ImageCache::get().get_texture(source, width, height);
+        }, m_source);
+
+        if (texture == nullptr)
+            Box::draw(rd);
+        else
+            rd.draw_texture(m_visual_rect, *texture);
+    }
+
+    [[nodiscard]] std::string format() const override {
+        return "Image";
+    }
+
+protected:
+    const Source m_source;
+
+};
+
+} // namespace ui
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <list>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+
+#include <gfx/gfx.h>
+
+namespace ui {
+
+// An encoded image in memory, eg: a png. The content hash is computed once on
+// construction, so it should be kept around instead of being recreated every
+// frame. The bytes are not copied, they have to outlive every frame the image
+// is shown in.
+class EncodedImage {
+public:
+    using Hash = uint64_t;
+
+    explicit EncodedImage(std::span<const std::byte> bytes)
+        : m_bytes(bytes)
+        , m_hash(hash(bytes))
+    { }
+
+    [[nodiscard]] std::span<const std::byte> get_bytes() const {
+        return m_bytes;
+    }
+
+    [[nodiscard]] Hash get_hash() const {
+        return m_hash;
+    }
+
+    // FNV-1a
+    [[nodiscard]] static Hash hash(std::span<const std::byte> bytes) {
+        Hash hash = 0xcbf29ce484222325;
+        for (auto byte : bytes) {
+            hash ^= static_cast<Hash>(byte);
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+private:
+    std::span<const std::byte> m_bytes;
+    Hash m_hash;
+
+};
+
+// Process-wide cache of decoded images, shared by all Ui instances. Images are
+// decoded on worker threads and the resulting textures are keyed by the hash of
+// the encoded image and the size they were scaled to. Textures are uploaded in
+// begin_frame() and the least recently used ones are evicted in end_frame()
+// once the memory budget is exceeded. Apart from the workers, the cache must
+// only be used from the render thread.
+//
+// Textures are assumed to be usable by every window, as gfx shares one
+// graphics context between them.
+class ImageCache {
+public:
+    using Hash = EncodedImage::Hash;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t default_budget = 256 * 1024 * 1024; // bytes
+    static constexpr size_t uploads_per_frame = 4;
+    static constexpr size_t max_pending_jobs = 256;
+    // images that failed to load (eg: a file that does not exist yet) are
+    // tried again after this long
+    static constexpr Clock::duration default_failure_timeout = std::chrono::seconds(2);
+
+    // the instance shared by all Ui instances
+    static ImageCache& get() {
+        static ImageCache instance;
+        return instance;
+    }
+
+    // separate caches are only useful for testing
+    ImageCache() = default;
+
+    ~ImageCache() {
+        stop_workers();
+    }
+
+    ImageCache(const ImageCache&) = delete;
+    ImageCache(ImageCache&&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+    ImageCache& operator=(ImageCache&&) = delete;
+
+    // every Ui holds a reference to the cache. once the last one is released,
+    // all textures are destroyed, so they never outlive the windows.
+    void acquire() {
+        m_users++;
+    }
+
+    void release() {
+        assert(m_users > 0);
+        if (--m_users == 0)
+            clear();
+    }
+
+    // returns the texture for the image, or nullptr if it is still being decoded
+    [[nodiscard]] const gfx::Texture* get_texture(const std::filesystem::path& path, int width, int height) {
+        Hash source = std::hash<std::filesystem::path>{}(path);
+        return get_texture(source, width, height, [&] {
+            return [path] { return read_file(path); };
+        });
+    }
+
+    // the bytes are only copied when a decode is scheduled
+    [[nodiscard]] const gfx::Texture* get_texture(const EncodedImage& image, int width, int height) {
+        // the source is identified by its contents already
+        Hash source = image.get_hash();
+        m_contents.try_emplace(source, source);
+
+        return get_texture(source, width, height, [&] {
+            auto bytes = image.get_bytes();
+            return [copy = std::vector(bytes.begin(), bytes.end())] { return copy; };
+        });
+    }
+
+    // uploads decoded images, needs to be called once per frame on the render
+    // thread before drawing
+    void begin_frame() {
+        m_frame++;
+
+        std::vector<Result> results;
+        {
+            std::scoped_lock lock(m_results_mutex);
+            auto count = std::min(m_results.size(), uploads_per_frame);
+            std::move(m_results.begin(), m_results.begin() + count, std::back_inserter(results));
+            m_results.erase(m_results.begin(), m_results.begin() + count);
+        }
+
+        for (auto& result : results)
+            upload(std::move(result));
+    }
+
+    // evicts textures to stay within budget, needs to be called after drawing
+    void end_frame() {
+        evict();
+        m_last_evicted_frame = m_frame;
+    }
+
+    [[nodiscard]] size_t get_memory_usage() const {
+        return m_memory_usage;
+    }
+
+    void set_budget(size_t budget) {
+        m_budget = budget;
+    }
+
+    void set_failure_timeout(Clock::duration timeout) {
+        m_failure_timeout = timeout;
+    }
+
+private:
+    struct Key {
+        Hash content;
+        int width;
+        int height;
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return key.content ^ (static_cast<size_t>(key.width) << 32 | static_cast<size_t>(key.height));
+        }
+    };
+
+    struct Entry {
+        gfx::Texture texture;
+        size_t size;
+        uint64_t last_used;
+        std::list<Key>::iterator lru;
+    };
+
+    struct Job {
+        Hash source;
+        int width;
+        int height;
+        std::function<std::vector<std::byte>()> load;
+    };
+
+    struct Result {
+        Hash source;
+        std::optional<Hash> content;
+        int width;
+        int height;
+        std::optional<gfx::Image> image;
+    };
+
+    size_t m_budget = default_budget;
+    Clock::duration m_failure_timeout = default_failure_timeout;
+    size_t m_memory_usage = 0;
+    size_t m_users = 0;
+    uint64_t m_frame = 0;
+    uint64_t m_last_evicted_frame = 0;
+
+    std::unordered_map<Key, Entry, KeyHash> m_textures;
+    std::list<Key> m_lru; // most recently used first
+
+    // maps the source of an image to the hash of its contents
+    std::unordered_map<Hash, Hash> m_contents;
+    // sources which failed to load, and when they may be tried again
+    std::unordered_map<Hash, Clock::time_point> m_failed;
+
+    // sources (combined with the requested size) which are queued or decoding
+    std::unordered_set<Key, KeyHash> m_pending;
+
+    std::mutex m_jobs_mutex;
+    std::condition_variable_any m_jobs_cv;
+    std::deque<Job> m_jobs;
+
+    std::mutex m_results_mutex;
+    std::vector<Result> m_results;
+
+    // started on the first decode, so applications without images have no workers
+    std::vector<std::jthread> m_workers;
+
+    [[nodiscard]] static unsigned int get_worker_count() {
+        return std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    }
+
+    // make_load is only invoked if a decode has to be scheduled, and returns
+    // the function which loads the encoded image on the worker thread
+    template <typename MakeLoad>
+    [[nodiscard]] const gfx::Texture* get_texture(Hash source, int width, int height, MakeLoad make_load) {
+
+        if (auto content = m_contents.find(source); content != m_contents.end()) {
+            if (auto it = m_textures.find({ content->second, width, height }); it != m_textures.end()) {
+                auto& entry = it->second;
+                entry.last_used = m_frame;
+                m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+                return &entry.texture;
+            }
+        }
+
+        if (auto failed = m_failed.find(source); failed != m_failed.end()) {
+            if (Clock::now() < failed->second)
+                return nullptr;
+
+            m_failed.erase(failed);
+        }
+
+        if (m_pending.insert({ source, width, height }).second)
+            schedule({ source, width, height, make_load() });
+
+        return nullptr;
+    }
+
+    void schedule(Job job) {
+        if (m_workers.empty())
+            start_workers();
+
+        {
+            std::scoped_lock lock(m_jobs_mutex);
+            m_jobs.push_back(std::move(job));
+
+            // when scrolling, older requests are likely not visible anymore.
+            // they will be scheduled again if they are still requested.
+            if (m_jobs.size() > max_pending_jobs) {
+                auto& oldest = m_jobs.front();
+                m_pending.erase({ oldest.source, oldest.width, oldest.height });
+                m_jobs.pop_front();
+            }
+        }
+
+        m_jobs_cv.notify_one();
+    }
+
+    void start_workers() {
+        for (unsigned int i = 0; i < get_worker_count(); ++i)
+            m_workers.emplace_back(std::bind_front(&ImageCache::worker, this));
+    }
+
+    // queued jobs are dropped, so only the decodes already running are waited for
+    void stop_workers() {
+        {
+            std::scoped_lock lock(m_jobs_mutex);
+            m_jobs.clear();
+        }
+
+        for (auto& worker : m_workers)
+            worker.request_stop();
+
+        m_jobs_cv.notify_all();
+        m_workers.clear();
+    }
+
+    // destroys all textures and drops queued work
+    void clear() {
+        stop_workers();
+
+        m_results.clear();
+        m_pending.clear();
+        m_failed.clear();
+        m_contents.clear();
+        m_lru.clear();
+        m_textures.clear();
+        m_memory_usage = 0;
+    }
+
+    void worker(std::stop_token stop) {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock(m_jobs_mutex);
+                // the wait returns the predicate even if stop has been requested
+                m_jobs_cv.wait(lock, stop, [&] { return not m_jobs.empty(); });
+                if (stop.stop_requested() or m_jobs.empty())
+                    return;
+
+                // newest requests first, as they are the ones currently on screen
+                job = std::move(m_jobs.back());
+                m_jobs.pop_back();
+            }
+
+            auto result = decode(std::move(job));
+
+            std::scoped_lock lock(m_results_mutex);
+            m_results.push_back(std::move(result));
+        }
+    }
+
+    [[nodiscard]] static Result decode(Job job) {
+        Result result { job.source, std::nullopt, job.width, job.height, std::nullopt };
+
+        try {
+            auto bytes = job.load();
+            if (bytes.empty()) return result;
+
+            result.content = EncodedImage::hash(bytes);
+            gfx::Image image(bytes);
+
+            if (image.get_width() != job.width or image.get_height() != job.height)
+                image = image.resize(job.width, job.height);
+
+            result.image = std::move(image);
+
+        } catch (const std::exception&) {
+            result.image.reset();
+        }
+
+        return result;
+    }
+
+    void upload(Result result) {
+        m_pending.erase({ result.source, result.width, result.height });
+
+        if (not result.content.has_value() or not result.image.has_value()) {
+            m_failed[result.source] = Clock::now() + m_failure_timeout;
+            return;
+        }
+
+        m_contents[result.source] = *result.content;
+
+        // the same image may have been loaded from another source already
+        Key key { *result.content, result.width, result.height };
+        if (m_textures.contains(key)) return;
+
+        size_t size = static_cast<size_t>(result.width) * result.height * 4;
+        m_lru.push_front(key);
+        m_textures.emplace(key, Entry { gfx::Texture(*result.image), size, m_frame, m_lru.begin() });
+        m_memory_usage += size;
+    }
+
+    // textures which have been used since the previous eviction are kept, so
+    // the images on screen of every Ui survive, even if they exceed the budget
+    void evict() {
+        while (m_memory_usage > m_budget and not m_lru.empty()) {
+            auto key = m_lru.back();
+            auto it = m_textures.find(key);
+
+            if (it->second.last_used >= m_last_evicted_frame) break;
+
+            m_memory_usage -= it->second.size;
+            m_textures.erase(it);
+            m_lru.pop_back();
+        }
+    }
+
+    [[nodiscard]] static std::vector<std::byte> read_file(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (not file) return {};
+
+        std::vector<std::byte> bytes(std::filesystem::file_size(path));
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+};
+
+} // namespace ui
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+
+#include <gfx/gfx.h>
+
+namespace ui {
+
+// The state of a mouse button or key at the time the input was sampled.
+class ButtonState {
+public:
+    ButtonState(bool is_pressed, bool is_clicked)
+        : m_is_pressed(is_pressed)
+        , m_is_clicked(is_clicked)
+    { }
+
+    template <typename State>
+    [[nodiscard]] static ButtonState from(const State& state) {
+        return { state.is_pressed(), state.is_clicked() };
+    }
+
+    [[nodiscard]] bool is_pressed() const {
+        return m_is_pressed;
+    }
+
+    [[nodiscard]] bool is_clicked() const {
+        return m_is_clicked;
+    }
+
+private:
+    bool m_is_pressed;
+    bool m_is_clicked;
+
+};
+
+// A snapshot of the input state elements react to. Elements never query the
+// window directly, so the tree can be built off the render thread, and the
+// pointer can be sampled again right before drawing. Snapshots can also be
+// created by hand, eg: to test elements or to replay recorded input.
+class Input {
+public:
+    using Clock = std::chrono::steady_clock;
+    using KeyState = ButtonState;
+
+    Input(gfx::Vec mouse_pos, ButtonState mouse_left, KeyState backspace, Clock::time_point sample_time)
+        : m_mouse_pos(mouse_pos)
+        , m_mouse_left(mouse_left)
+        , m_backspace(backspace)
+        , m_sample_time(sample_time)
+    { }
+
+    [[nodiscard]] static Input sample(gfx::Window& window) {
+        return {
+            window.get_mouse_pos(),
+            ButtonState::from(window.get_mouse_button_state(gfx::MouseButton::Left)),
+            KeyState::from(window.get_key_state(gfx::Key::Backspace)),
+            Clock::now(),
+        };
+    }
+
+    [[nodiscard]] gfx::Vec get_mouse_pos() const {
+        return m_mouse_pos;
+    }
+
+    [[nodiscard]] ButtonState get_mouse_left() const {
+        return m_mouse_left;
+    }
+
+    [[nodiscard]] KeyState get_backspace() const {
+        return m_backspace;
+    }
+
+    [[nodiscard]] Clock::time_point get_sample_time() const {
+        return m_sample_time;
+    }
+
+private:
+    gfx::Vec m_mouse_pos;
+    ButtonState m_mouse_left;
+    KeyState m_backspace;
+    Clock::time_point m_sample_time;
+
+};
+
+} // namespace ui
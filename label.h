@@ -9,19 +9,22 @@ namespace ui {
 
 class Label : public virtual Box {
 public:
-    Label(Id id, gfx::Window& window, gfx::Vec position, Style style, std::string_view text, const gfx::Font& font)
+    // the text is measured by the caller, so the font is not accessed when
+    // the tree is built off the render thread
+    Label(Id id, gfx::Window& window, gfx::Vec position, Style style, std::string_view text, const gfx::Font& font, int text_width)
         : Box(id, window, position, style, 0.0f, 0.0f)
+        , m_fontsize(style.font_size)
         , m_text(text)
         , m_font(font)
     {
         m_rect.height = m_fontsize + m_style.padding * 2.0f;
-        m_rect.width = m_font.measure_text(m_text, m_fontsize) + m_style.padding * 2.0f;
+        m_rect.width = text_width + m_style.padding * 2.0f;
     }
 
     void draw(gfx::Renderer& rd) const override {
         Box::draw(rd);
         float padding = m_style.padding;
-        rd.draw_text(m_rect.x + padding, m_rect.y + padding, m_fontsize, m_text, m_font, m_style.color_text);
+        rd.draw_text(m_visual_rect.x + padding, m_visual_rect.y + padding, m_fontsize, m_text, m_font, m_style.color_text);
     }
 
     [[nodiscard]] std::string format() const override {
@@ -29,7 +32,7 @@ public:
     }
 
 protected:
-    const int m_fontsize = 50;
+    const int m_fontsize;
     const std::string_view m_text;
     const gfx::Font& m_font;
 
@@ -7,21 +7,47 @@
 // TODO: auxilary layout class
 // TODO: glfw repeated for text input backspace
 
-int main() {
+int main(int argc, char** argv) {
+
+    // builds the tree on a worker thread, see ui::Ui::Mode::Pipelined
+    bool is_pipelined = argc > 1 and std::string_view(argv[1]) == "--pipelined";
+    auto mode = is_pipelined ? ui::Ui::Mode::Pipelined : ui::Ui::Mode::Immediate;
 
     auto flags = gfx::WindowFlags()
         .enable_resizing(true);
 
     gfx::Window window(1920, 1080, "ui", flags);
-    ui::Ui ui(window);
+    ui::Ui ui(window, mode);
 
     std::string input("hello, input");
+    auto scroll_offset = gfx::Vec::zero();
+
+    // labels only keep a view of their text, so it has to outlive the frame
+    std::vector<std::string> items;
+    for (int i = 0; i < 100; ++i)
+        items.push_back(std::format("item {}", i));
+
+    // laid out at compile time
+    static constexpr auto toolbar = ui::fixed::horizontal({ .padding=5.0f, .color=0 },
+        ui::fixed::box(40.0f, 40.0f, { .margin=5.0f, .border_radius=10.0f, .color=1 }),
+        ui::fixed::box(40.0f, 40.0f, { .margin=5.0f, .border_radius=10.0f, .color=2 }),
+        ui::fixed::box(40.0f, 40.0f, { .margin=5.0f, .border_radius=10.0f, .color=3 })
+    );
+
+    std::array toolbar_palette {
+        gfx::Color::gray(),
+        gfx::Color::orange(),
+        gfx::Color::blue(),
+        gfx::Color::white(),
+    };
 
     window.draw_loop([&](gfx::Renderer& rd) {
         rd.clear_background(gfx::Color::black());
 
         ui.root(rd, [&](ui::Ui& ui) {
 
+            ui.fixed_block(toolbar, toolbar_palette);
+
             ui.horizontal([&] {
                 ui.label("hello");
                 ui.label("world");
@@ -32,6 +58,7 @@ int main() {
                 .color_bg=gfx::Color::orange(),
                 .padding=20.0f,
                 .border_radius=15.0f,
+                .transition={ .duration=0.15f },
             };
 
             if (ui.button("click me", button_style).is_pressed()) {
@@ -40,6 +67,11 @@ int main() {
 
             ui.text_input(500, input, { .color_bg=gfx::Color::blue() });
 
+            ui.scroll(500, 300, scroll_offset, [&] {
+                for (const auto& item : items)
+                    ui.label(item);
+            }, { .color_bg=gfx::Color::blue(), .padding=10.0f });
+
         }, { .color_bg=gfx::Color::gray(), .padding=10.0f });
 
         if (window.get_key_state(gfx::Key::Escape).is_pressed())
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <optional>
+
+#include <gfx/gfx.h>
+
+#include "clip.h"
+#include "container.h"
+
+namespace ui {
+
+// A vertical container with a fixed size, which clips its children and shows
+// them shifted by `offset`. The offset can be changed by the user, or by
+// dragging the content with the mouse.
+class ScrollContainer : public Container {
+public:
+    ScrollContainer(Id id, gfx::Window& window, gfx::Vec position, Style style, std::vector<std::unique_ptr<Box>> children, float width, float height, gfx::Vec& offset)
+        : Container(id, window, position, style, std::move(children), Direction::Vertical)
+        , m_offset(offset)
+        , m_content_width(m_rect.width)
+        , m_content_height(m_rect.height)
+    {
+        m_rect.width = width;
+        m_rect.height = height;
+        clamp_offset();
+    }
+
+    [[nodiscard]] std::any export_state() const override {
+        return m_drag;
+    }
+
+    void apply_state(std::any state) override {
+        m_drag = std::any_cast<DragState>(state);
+    }
+
+    // the whole viewport is scrollable, so presses are never meant for parents
+    [[nodiscard]] bool captures_mouse() const override {
+        return is_hovered();
+    }
+
+    // the region children are clipped to, in screen coordinates
+    [[nodiscard]] gfx::Rect get_viewport() const {
+        return intersect(m_rect, m_clip_rect);
+    }
+
+    // dragging starts when the left button goes down over the viewport, unless
+    // the press is meant for one of the children
+    void handle_input() override {
+        bool is_pressed = m_input->get_mouse_left().is_pressed();
+        bool is_press_start = is_pressed and not m_drag.was_pressed;
+        m_drag.was_pressed = is_pressed;
+
+        if (not is_pressed) {
+            m_drag.origin.reset();
+            return;
+        }
+
+        auto mouse = m_input->get_mouse_pos();
+
+        if (m_drag.origin.has_value()) {
+            m_offset.x -= mouse.x - m_drag.origin->x;
+            m_offset.y -= mouse.y - m_drag.origin->y;
+            clamp_offset();
+            m_drag.origin = mouse;
+
+        } else if (is_press_start and is_hovered() and not Container::captures_mouse()) {
+            m_drag.origin = mouse;
+        }
+    }
+
+    void draw(gfx::Renderer& rd) const override {
+        Box::draw(rd);
+
+        rd.begin_scissor(get_viewport());
+        draw_children(rd);
+        rd.end_scissor();
+
+        // nested scroll containers have to restore the scissor of their parent
+        if (is_bounded(m_clip_rect))
+            rd.begin_scissor(m_clip_rect);
+    }
+
+    [[nodiscard]] std::string format() const override {
+        return std::format("ScrollContainer ({}, {})", m_offset.x, m_offset.y);
+    }
+
+protected:
+    // children are stacked vertically in order, so the visible ones can be
+    // found with a binary search instead of checking every child
+    [[nodiscard]] ChildRange get_visible_range() const override {
+        auto viewport = get_viewport();
+        ChildRange children = m_children;
+
+        auto first = ranges::partition_point(children, [&](const std::unique_ptr<Box>& child) {
+            const auto& rect = child->get_rect();
+            return rect.y + rect.height <= viewport.y;
+        });
+
+        auto last = std::partition_point(first, children.end(), [&](const std::unique_ptr<Box>& child) {
+            return child->get_rect().y < viewport.y + viewport.height;
+        });
+
+        return { first, last };
+    }
+
+private:
+    gfx::Vec& m_offset;
+    const float m_content_width;
+    const float m_content_height;
+    struct DragState {
+        std::optional<gfx::Vec> origin;
+        // a button held down when the container appears must not start a drag
+        bool was_pressed = true;
+    };
+
+    DragState m_drag;
+
+    void clamp_offset() {
+        m_offset.x = std::clamp(m_offset.x, 0.0f, std::max(m_content_width - m_rect.width, 0.0f));
+        m_offset.y = std::clamp(m_offset.y, 0.0f, std::max(m_content_height - m_rect.height, 0.0f));
+    }
+
+};
+
+} // namespace ui
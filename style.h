@@ -2,9 +2,10 @@
 
 #include <gfx/gfx.h>
 
+#include "animation.h"
+
 namespace ui {
 
-// TODO: font
 struct Style {
     // Box
     gfx::Color color_bg = gfx::Color::black();
@@ -14,10 +15,14 @@ struct Style {
 
     // Label
     gfx::Color color_text = gfx::Color::white();
+    int font_size = 50;
 
     // Button
     gfx::Color color_hover = gfx::Color::white();
     gfx::Color color_press = gfx::Color::black();
+
+    // animates color, rect and border radius changes
+    Transition transition = {};
 };
 
 } // namespace ui
@@ -0,0 +1,79 @@
+#include <print>
+#include <chrono>
+#include <cstdlib>
+
+#include <gfx/gfx.h>
+
+#include "../animation.h"
+
+// measures one update() of n running rect, color and float transitions
+
+using Clock = std::chrono::steady_clock;
+
+struct Tracks {
+    ui::AnimationTrack<uint64_t, gfx::Rect> rects;
+    ui::AnimationTrack<uint64_t, gfx::Color> colors;
+    ui::AnimationTrack<uint64_t, float> floats;
+
+    void update(float now) {
+        rects.update(now);
+        colors.update(now);
+        floats.update(now);
+    }
+};
+
+static void start_transitions(Tracks& tracks, size_t n) {
+    ui::Transition transition { .duration=1.0f, .easing=ui::Easing::EaseInOut };
+
+    // the first frame only records the initial values
+    for (uint64_t i = 0; i < n; ++i) {
+        std::ignore = tracks.rects.track(i, { 0.0f, 0.0f, 10.0f, 10.0f }, transition, 0.0f, 1);
+        std::ignore = tracks.colors.track(i, gfx::Color::black(), transition, 0.0f, 1);
+        std::ignore = tracks.floats.track(i, 0.0f, transition, 0.0f, 1);
+    }
+
+    for (uint64_t i = 0; i < n; ++i) {
+        std::ignore = tracks.rects.track(i, { 100.0f, 50.0f, 20.0f, 30.0f }, transition, 0.0f, 2);
+        std::ignore = tracks.colors.track(i, gfx::Color::white(), transition, 0.0f, 2);
+        std::ignore = tracks.floats.track(i, 15.0f, transition, 0.0f, 2);
+    }
+}
+
+static bool bench(size_t n) {
+    Tracks tracks;
+    start_transitions(tracks, n);
+
+    constexpr int iterations = 100;
+    auto start = Clock::now();
+
+    for (int i = 0; i < iterations; ++i)
+        tracks.update(0.5f);
+
+    auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start) / iterations;
+    auto active = tracks.rects.active_count() + tracks.colors.active_count() + tracks.floats.active_count();
+    std::println("{:>6} widgets, {:>6} transitions: {:.2f}us per update", n, active, elapsed.count());
+
+    if (active != n * 3) {
+        std::println(stderr, "expected {} running transitions, got {}", n * 3, active);
+        return false;
+    }
+
+    // all transitions have finished, so the targets have to be reached exactly
+    tracks.update(1.0f);
+    auto rect = tracks.rects.track(0, { 100.0f, 50.0f, 20.0f, 30.0f }, {}, 1.0f, 3);
+    float value = tracks.floats.track(0, 15.0f, {}, 1.0f, 3);
+
+    if (tracks.rects.active_count() != 0 or rect.x != 100.0f or rect.height != 30.0f or value != 15.0f) {
+        std::println(stderr, "transitions did not settle on their targets");
+        return false;
+    }
+
+    return true;
+}
+
+int main() {
+    for (size_t n : { 100, 1'000, 10'000 }) {
+        if (not bench(n))
+            return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,74 @@
+#include <array>
+#include <print>
+#include <chrono>
+
+#include <gfx/gfx.h>
+
+#include "../ui.h"
+
+// compares the cost of a frame with n boxes inside of a fixed size scroll
+// container, to the same boxes without clipping. only a handful of the boxes
+// in the scroll container are visible, so the draw time should stay constant,
+// while building the tree still scales with the total number of boxes.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::array counts { 100, 1'000, 10'000 };
+constexpr int frames_per_run = 60;
+
+enum class Layout { Scrolled, Unclipped };
+
+struct Run {
+    int count;
+    Layout layout;
+    Clock::duration total {};
+    Clock::duration draw {};
+};
+
+int main() {
+    gfx::Window window(800, 600, "bench_scroll", gfx::WindowFlags());
+    ui::Ui ui(window);
+    ui.set_debug_output(false);
+
+    std::vector<Run> runs;
+    for (int count : counts) {
+        runs.push_back({ count, Layout::Scrolled });
+        runs.push_back({ count, Layout::Unclipped });
+    }
+
+    auto offset = gfx::Vec::zero();
+    int frame = 0;
+
+    window.draw_loop([&](gfx::Renderer& rd) {
+        auto& run = runs[frame / frames_per_run];
+        auto start = Clock::now();
+
+        ui.root(rd, [&](ui::Ui& ui) {
+            auto boxes = [&] {
+                for (int i = 0; i < run.count; ++i)
+                    ui.box(380.0f, 20.0f, { .color_bg=gfx::Color::blue(), .margin=1.0f });
+            };
+
+            if (run.layout == Layout::Scrolled)
+                ui.scroll(400.0f, 400.0f, offset, boxes);
+            else
+                ui.vertical(boxes);
+        });
+
+        run.total += Clock::now() - start;
+        run.draw += ui.get_frame_stats().draw_time;
+
+        if (++frame == static_cast<int>(runs.size()) * frames_per_run)
+            window.close();
+    });
+
+    for (const auto& run : runs) {
+        using Micros = std::chrono::duration<double, std::micro>;
+        auto total = Micros(run.total) / frames_per_run;
+        auto draw = Micros(run.draw) / frames_per_run;
+        auto layout = run.layout == Layout::Scrolled ? "scrolled" : "unclipped";
+
+        std::println("{:>6} boxes, {:>9}: {:.1f}us per frame, {:.1f}us of it drawing",
+                     run.count, layout, total.count(), draw.count());
+    }
+}
@@ -0,0 +1,116 @@
+#include <array>
+#include <print>
+#include <vector>
+#include <cstdlib>
+#include <utility>
+
+#include <gfx/gfx.h>
+
+#include "../ui.h"
+
+// checks that layouts computed at compile time match the rects of the same
+// tree built with Ui::box(), Ui::horizontal() and Ui::vertical()
+
+namespace fixed = ui::fixed;
+
+static constexpr auto layout = fixed::vertical({ .padding=5 },
+    fixed::box(40, 40, { .margin=5 }),
+    fixed::horizontal({ .margin=2, .padding=1 },
+        fixed::box(10, 20),
+        fixed::box(30, 5, { .margin=1, .color=1 })
+    )
+);
+
+static const std::array palette { gfx::Color::blue(), gfx::Color::orange() };
+
+static_assert(layout.commands.size() == 5);
+static_assert(layout.root().width == 58 and layout.root().height == 86);
+static_assert(layout.commands[1].x == 10 and layout.commands[1].y == 10);
+static_assert(layout.commands[2].x == 7 and layout.commands[2].y == 57);
+static_assert(layout.commands[2].width == 44 and layout.commands[2].height == 22);
+// children of a container do not include its margin, same as Ui::horizontal()
+static_assert(layout.commands[3].x == 6 and layout.commands[3].y == 56);
+static_assert(layout.commands[4].x == 17 and layout.commands[4].y == 57);
+static_assert(layout.commands[4].color == 1);
+
+// the commands of a temporary would dangle, so it must not bind
+template <typename Layout>
+concept accepts_layout = requires(ui::Ui& ui, Layout&& layout) {
+    ui.fixed_block(std::forward<Layout>(layout), palette);
+};
+
+static_assert(accepts_layout<const fixed::Layout<1>&>);
+static_assert(not accepts_layout<fixed::Layout<1>>);
+
+static void flatten(const ui::Box& box, gfx::Vec origin, std::vector<gfx::Rect>& rects) {
+    auto rect = box.get_rect();
+    rects.emplace_back(rect.x - origin.x, rect.y - origin.y, rect.width, rect.height);
+    box.for_each_child([&](ui::Box& child) { flatten(child, origin, rects); });
+}
+
+// rects of the subtree in preorder, relative to the position the subtree was
+// placed at, which is the same origin the commands are relative to
+static std::vector<gfx::Rect> flatten(const ui::Box& root) {
+    gfx::Vec origin(root.get_rect().x - root.get_style().margin, root.get_rect().y - root.get_style().margin);
+
+    std::vector<gfx::Rect> rects;
+    flatten(root, origin, rects);
+    return rects;
+}
+
+int main() {
+    gfx::Window window(800, 600, "fixed_layout", gfx::WindowFlags());
+    ui::Ui ui(window);
+    ui.set_debug_output(false);
+
+    window.draw_loop([&](gfx::Renderer& rd) {
+        ui.root(rd, [&](ui::Ui& ui) {
+            ui.fixed_block(layout, palette);
+
+            ui.vertical([&] {
+                ui.box(40, 40, { .margin=5 });
+                ui.horizontal([&] {
+                    ui.box(10, 20);
+                    ui.box(30, 5, { .margin=1 });
+                }, { .margin=2, .padding=1 });
+            }, { .padding=5 });
+        });
+
+        window.close();
+    });
+
+    std::vector<const ui::Box*> blocks;
+    ui.get_root()->for_each_child([&](ui::Box& child) { blocks.push_back(&child); });
+
+    if (blocks.size() != 2) {
+        std::println(stderr, "expected 2 elements in the root, got {}", blocks.size());
+        return EXIT_FAILURE;
+    }
+
+    const auto& block = *blocks[0];
+    auto rects = flatten(*blocks[1]);
+
+    if (block.get_rect().width != layout.root().width or block.get_rect().height != layout.root().height) {
+        std::println(stderr, "size of the fixed block does not match its layout");
+        return EXIT_FAILURE;
+    }
+
+    if (rects.size() != layout.commands.size()) {
+        std::println(stderr, "expected {} elements, got {}", layout.commands.size(), rects.size());
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < rects.size(); ++i) {
+        const auto& rect = rects[i];
+        const auto& cmd = layout.commands[i];
+
+        if (rect.x != cmd.x or rect.y != cmd.y or rect.width != cmd.width or rect.height != cmd.height) {
+            std::println(stderr, "element {}: expected {} {} {} {}, got {} {} {} {}", i,
+                         cmd.x, cmd.y, cmd.width, cmd.height,
+                         rect.x, rect.y, rect.width, rect.height);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::println("{} elements match", rects.size());
+}
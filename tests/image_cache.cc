@@ -0,0 +1,245 @@
+#include <print>
+#include <tuple>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+
+#include <gfx/gfx.h>
+
+#include "../image_cache.h"
+
+// checks budget eviction in lru order, sharing textures between sources with
+// the same contents and retrying failed loads, then measures how long it
+// takes until a few hundred thumbnails are ready.
+
+using Clock = std::chrono::steady_clock;
+using Micros = std::chrono::duration<double, std::micro>;
+
+constexpr int size = 8;
+constexpr size_t texture_size = size * size * 4;
+constexpr int thumbnail_count = 500;
+constexpr int thumbnail_size = 64;
+
+// an uncompressed 24 bit bmp filled with a single color
+static std::vector<std::byte> encode_bmp(int width, int height, uint32_t rgb) {
+    int row_size = (width * 3 + 3) & ~3;
+    int data_size = row_size * height;
+    std::vector<std::byte> bytes(54 + data_size);
+
+    auto put = [&](size_t offset, uint32_t value, int count) {
+        for (int i = 0; i < count; ++i)
+            bytes[offset + i] = static_cast<std::byte>(value >> (i * 8));
+    };
+
+    bytes[0] = std::byte('B');
+    bytes[1] = std::byte('M');
+    put(2, static_cast<uint32_t>(bytes.size()), 4);
+    put(10, 54, 4);
+    put(14, 40, 4);
+    put(18, width, 4);
+    put(22, height, 4);
+    put(26, 1, 2);
+    put(28, 24, 2);
+    put(34, data_size, 4);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x)
+            put(54 + y * row_size + x * 3, rgb, 3); // stored as bgr
+    }
+
+    return bytes;
+}
+
+// runs frames until request() returns true, returns the number of frames
+template <typename Fn>
+static int run_frames(ui::ImageCache& cache, Fn request) {
+    constexpr int max_frames = 2'000;
+
+    for (int frame = 1; frame <= max_frames; ++frame) {
+        cache.begin_frame();
+        bool is_done = request();
+        cache.end_frame();
+
+        if (is_done)
+            return frame;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return 0;
+}
+
+static void run_empty_frames(ui::ImageCache& cache, int count) {
+    for (int i = 0; i < count; ++i) {
+        cache.begin_frame();
+        cache.end_frame();
+    }
+}
+
+static bool test_eviction() {
+    ui::ImageCache cache;
+    cache.set_budget(texture_size * 2);
+
+    auto a_bytes = encode_bmp(size, size, 0xff0000);
+    auto b_bytes = encode_bmp(size, size, 0x00ff00);
+    auto c_bytes = encode_bmp(size, size, 0x0000ff);
+    ui::EncodedImage a(a_bytes), b(b_bytes), c(c_bytes);
+
+    bool is_loaded = run_frames(cache, [&] {
+        bool has_b = cache.get_texture(b, size, size) != nullptr;
+        // requested last, so a is the most recently used one
+        bool has_a = cache.get_texture(a, size, size) != nullptr;
+        return has_a and has_b;
+    });
+
+    if (not is_loaded or cache.get_memory_usage() != texture_size * 2) {
+        std::println(stderr, "eviction: a and b did not fit into the budget");
+        return false;
+    }
+
+    // a and b are not on screen anymore, so they may be evicted
+    run_empty_frames(cache, 2);
+
+    is_loaded = run_frames(cache, [&] {
+        return cache.get_texture(c, size, size) != nullptr;
+    });
+
+    if (not is_loaded or cache.get_memory_usage() != texture_size * 2) {
+        std::println(stderr, "eviction: expected {} bytes after loading c, got {}", texture_size * 2, cache.get_memory_usage());
+        return false;
+    }
+
+    cache.begin_frame();
+    bool has_a = cache.get_texture(a, size, size) != nullptr;
+    bool has_b = cache.get_texture(b, size, size) != nullptr;
+    cache.end_frame();
+
+    if (not has_a or has_b) {
+        std::println(stderr, "eviction: expected the least recently used image to be evicted");
+        return false;
+    }
+
+    return true;
+}
+
+static bool test_shared_contents(const std::filesystem::path& dir) {
+    ui::ImageCache cache;
+
+    auto bytes = encode_bmp(size, size, 0x123456);
+    auto copy = bytes;
+    ui::EncodedImage first(bytes), second(copy);
+
+    auto path = dir / "shared.bmp";
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    const gfx::Texture* textures[3] {};
+
+    bool is_loaded = run_frames(cache, [&] {
+        textures[0] = cache.get_texture(first, size, size);
+        textures[1] = cache.get_texture(second, size, size);
+        textures[2] = cache.get_texture(path, size, size);
+        return textures[0] and textures[1] and textures[2];
+    });
+
+    if (not is_loaded) {
+        std::println(stderr, "shared contents: images did not load");
+        return false;
+    }
+
+    if (textures[0] != textures[1] or textures[0] != textures[2] or cache.get_memory_usage() != texture_size) {
+        std::println(stderr, "shared contents: identical images were uploaded more than once");
+        return false;
+    }
+
+    return true;
+}
+
+static bool test_failure_timeout(const std::filesystem::path& dir) {
+    ui::ImageCache cache;
+    cache.set_failure_timeout(std::chrono::milliseconds(50));
+
+    auto path = dir / "late.bmp";
+
+    // the file does not exist yet, so the first load fails
+    for (int i = 0; i < 20; ++i) {
+        cache.begin_frame();
+        std::ignore = cache.get_texture(path, size, size);
+        cache.end_frame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto bytes = encode_bmp(size, size, 0xabcdef);
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    bool is_loaded = run_frames(cache, [&] {
+        return cache.get_texture(path, size, size) != nullptr;
+    });
+
+    if (not is_loaded) {
+        std::println(stderr, "failure timeout: the file was never loaded after it appeared");
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_thumbnails() {
+    ui::ImageCache cache;
+
+    std::vector<std::vector<std::byte>> encoded;
+    for (int i = 0; i < thumbnail_count; ++i)
+        encoded.push_back(encode_bmp(thumbnail_size, thumbnail_size, static_cast<uint32_t>(i * 7919)));
+
+    std::vector<ui::EncodedImage> images(encoded.begin(), encoded.end());
+
+    auto request_all = [&] {
+        int ready = 0;
+        for (const auto& image : images)
+            ready += cache.get_texture(image, thumbnail_size, thumbnail_size) != nullptr;
+        return ready == thumbnail_count;
+    };
+
+    auto start = Clock::now();
+    int frames = run_frames(cache, request_all);
+    auto load_time = Clock::now() - start;
+
+    if (frames == 0) {
+        std::println(stderr, "thumbnails: not all images were loaded");
+        return false;
+    }
+
+    constexpr int iterations = 100;
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        cache.begin_frame();
+        std::ignore = request_all();
+        cache.end_frame();
+    }
+    auto frame_time = Micros(Clock::now() - start) / iterations;
+
+    std::println("{} thumbnails: ready after {} frames ({:.1f}ms), {:.1f}us per frame once cached",
+                 thumbnail_count, frames, Micros(load_time).count() / 1000.0, frame_time.count());
+
+    return true;
+}
+
+int main() {
+    // textures need a graphics context
+    gfx::Window window(800, 600, "image_cache", gfx::WindowFlags());
+
+    auto dir = std::filesystem::temp_directory_path() / "libui_image_cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    bool is_valid = test_eviction()
+        and test_shared_contents(dir)
+        and test_failure_timeout(dir)
+        and bench_thumbnails();
+
+    std::filesystem::remove_all(dir);
+
+    return is_valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+#include <print>
+#include <deque>
+#include <tuple>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include <gfx/gfx.h>
+
+#include "../ui.h"
+
+// builds the same ui in immediate and in pipelined mode, and checks that both
+// produce the same tree, while the pipelined one is drawn a frame later. also
+// moves the pointer between building and drawing a tree, to check that hover
+// visuals follow the late sample, while the state handed to the ui function
+// keeps the value it was built with.
+
+constexpr int frame_count = 10;
+
+static void build(ui::Ui& ui, std::string& input, gfx::Vec& offset, const std::vector<std::string>& items) {
+    ui.horizontal([&] {
+        ui.label("hello");
+        ui.button("button", { .padding=10.0f });
+    });
+
+    ui.text_input(200.0f, input);
+
+    ui.scroll(200.0f, 100.0f, offset, [&] {
+        for (const auto& item : items)
+            ui.label(item);
+    });
+}
+
+static const ui::Style button_style {
+    .color_bg=gfx::Color::blue(),
+    .padding=10.0f,
+    .color_hover=gfx::Color::orange(),
+};
+
+// the pointer positions returned by the input source, in the order they are
+// sampled. when pipelined, the input for building the next tree is sampled
+// first, then the input the previous tree is latched with.
+struct InputScript {
+    static inline const gfx::Vec over_button { 5.0f, 5.0f };
+    static inline const gfx::Vec outside { 1000.0f, 1000.0f };
+
+    std::deque<gfx::Vec> samples;
+
+    ui::Input next() {
+        auto mouse = samples.front();
+        samples.pop_front();
+        return ui::Input(mouse, { false, false }, { false, false }, ui::Input::Clock::now());
+    }
+};
+
+struct Expected {
+    bool is_hovered; // the state handed to the ui function when building
+    gfx::Color color; // as drawn
+};
+
+static bool equal(gfx::Color a, gfx::Color b) {
+    return a.r == b.r and a.g == b.g and a.b == b.b and a.a == b.a;
+}
+
+static void flatten(const ui::Box& box, std::vector<gfx::Rect>& rects) {
+    rects.push_back(box.get_rect());
+    box.for_each_child([&](ui::Box& child) { flatten(child, rects); });
+}
+
+int main() {
+    gfx::Window window(800, 600, "pipelined", gfx::WindowFlags());
+
+    ui::Ui immediate(window, ui::Ui::Mode::Immediate);
+    ui::Ui pipelined(window, ui::Ui::Mode::Pipelined);
+    immediate.set_debug_output(false);
+    pipelined.set_debug_output(false);
+
+    std::string immediate_input("text"), pipelined_input("text");
+    auto immediate_offset = gfx::Vec::zero();
+    auto pipelined_offset = gfx::Vec::zero();
+
+    std::vector<std::string> items;
+    for (int i = 0; i < 50; ++i)
+        items.push_back(std::format("item {}", i));
+
+    ui::Ui latched(window, ui::Ui::Mode::Pipelined);
+    latched.set_debug_output(false);
+
+    // frame 0 is only built. the tree built outside of the button is drawn
+    // with the pointer over it in frame 1, and the tree built over the button
+    // is drawn with the pointer outside in frame 2.
+    InputScript script { {
+        InputScript::outside,
+        InputScript::over_button, InputScript::over_button,
+        InputScript::outside, InputScript::outside,
+    } };
+    latched.set_input_source([&] { return script.next(); });
+
+    std::vector<Expected> expected_draws {
+        { false, button_style.color_hover },
+        { true, button_style.color_bg },
+    };
+    size_t draw_count = 0;
+
+    int frame = 0;
+    bool is_valid = true;
+
+    latched.set_draw_callback([&](const ui::Box& root) {
+        const ui::Button* button = nullptr;
+        root.for_each_child([&](ui::Box& child) { button = dynamic_cast<const ui::Button*>(&child); });
+
+        if (button == nullptr or draw_count >= expected_draws.size()) {
+            std::println(stderr, "frame {}: unexpected tree drawn", frame);
+            is_valid = false;
+            return;
+        }
+
+        const auto& [is_hovered, color] = expected_draws[draw_count++];
+
+        if (button->get_state().is_hovered() != is_hovered) {
+            std::println(stderr, "frame {}: the state handed out when building changed", frame);
+            is_valid = false;
+        }
+
+        if (not equal(button->get_visual_color(), color)) {
+            std::println(stderr, "frame {}: the drawn color does not follow the latched input", frame);
+            is_valid = false;
+        }
+    });
+
+    window.draw_loop([&](gfx::Renderer& rd) {
+        if (not script.samples.empty())
+            latched.root(rd, [&](ui::Ui& ui) { std::ignore = ui.button("button", button_style); });
+
+        immediate.root(rd, [&](ui::Ui& ui) { build(ui, immediate_input, immediate_offset, items); });
+        pipelined.root(rd, [&](ui::Ui& ui) { build(ui, pipelined_input, pipelined_offset, items); });
+
+        std::vector<gfx::Rect> expected, actual;
+        flatten(*immediate.get_root(), expected);
+        flatten(*pipelined.get_root(), actual);
+
+        auto equal = std::ranges::equal(expected, actual, [](const gfx::Rect& a, const gfx::Rect& b) {
+            return a.x == b.x and a.y == b.y and a.width == b.width and a.height == b.height;
+        });
+
+        if (not equal) {
+            std::println(stderr, "frame {}: trees differ", frame);
+            is_valid = false;
+        }
+
+        // the drawn tree was built with input sampled before the latched input
+        const auto& stats = pipelined.get_frame_stats();
+        if (frame > 0 and stats.structure_latency < stats.hover_latency) {
+            std::println(stderr, "frame {}: structure latency is below hover latency", frame);
+            is_valid = false;
+        }
+
+        if (++frame == frame_count)
+            window.close();
+    });
+
+    if (draw_count != expected_draws.size()) {
+        std::println(stderr, "expected {} latched draws, got {}", expected_draws.size(), draw_count);
+        is_valid = false;
+    }
+
+    if (not is_valid)
+        return EXIT_FAILURE;
+
+    const auto& stats = pipelined.get_frame_stats();
+    std::println("{} frames match, latency {}us (structure), {}us (hover)", frame_count,
+                 std::chrono::duration_cast<std::chrono::microseconds>(stats.structure_latency).count(),
+                 std::chrono::duration_cast<std::chrono::microseconds>(stats.hover_latency).count());
+}
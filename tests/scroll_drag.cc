@@ -0,0 +1,91 @@
+#include <array>
+#include <print>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include <gfx/gfx.h>
+
+#include "../ui.h"
+
+// drags the content of a scroll container with injected input, once with the
+// container as the last element of the root and once followed by a sibling.
+// the drag state is kept by id, so it must not be overwritten by other
+// elements of the tree.
+
+enum class Layout { Last, BeforeSibling };
+
+struct Step {
+    gfx::Vec mouse;
+    bool is_pressed;
+};
+
+struct Run {
+    Layout layout;
+    std::unique_ptr<ui::Ui> ui;
+    gfx::Vec offset = gfx::Vec::zero();
+};
+
+int main() {
+    gfx::Window window(800, 600, "scroll_drag", gfx::WindowFlags());
+
+    // press inside the viewport, drag up by 100px and release
+    std::vector<Step> steps {
+        { { 200.0f, 200.0f }, false },
+        { { 200.0f, 200.0f }, true },
+    };
+    for (float y = 180.0f; y >= 100.0f; y -= 20.0f)
+        steps.push_back({ { 200.0f, y }, true });
+    steps.push_back({ { 200.0f, 100.0f }, false });
+
+    size_t step = 0;
+    auto input = [&] {
+        const auto& [mouse, is_pressed] = steps[step];
+        return ui::Input(mouse, { is_pressed, false }, { false, false }, ui::Input::Clock::now());
+    };
+
+    std::array<Run, 2> runs {
+        Run { Layout::Last, std::make_unique<ui::Ui>(window) },
+        Run { Layout::BeforeSibling, std::make_unique<ui::Ui>(window) },
+    };
+
+    for (auto& run : runs) {
+        run.ui->set_debug_output(false);
+        run.ui->set_input_source(input);
+    }
+
+    window.draw_loop([&](gfx::Renderer& rd) {
+        for (auto& run : runs) {
+            run.ui->root(rd, [&](ui::Ui& ui) {
+                ui.scroll(400.0f, 300.0f, run.offset, [&] {
+                    for (int i = 0; i < 50; ++i)
+                        ui.box(380.0f, 20.0f);
+                });
+
+                if (run.layout == Layout::BeforeSibling) {
+                    ui.horizontal([&] {
+                        ui.box(20.0f, 20.0f);
+                    });
+                }
+            });
+        }
+
+        if (++step == steps.size())
+            window.close();
+    });
+
+    bool is_valid = true;
+
+    for (const auto& run : runs) {
+        auto name = run.layout == Layout::Last ? "last" : "before sibling";
+
+        if (run.offset.y != 100.0f) {
+            std::println(stderr, "{}: expected the drag to scroll by 100, got {}", name, run.offset.y);
+            is_valid = false;
+        } else {
+            std::println("{}: scrolled by {}", name, run.offset.y);
+        }
+    }
+
+    return is_valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+#include <print>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <unordered_set>
+
+#include <gfx/gfx.h>
+
+#include "../ui.h"
+
+// moves transitioned siblings and cousins at the same time, and checks that
+// every one of them settles on its own rect. transitions are keyed by id, so
+// this fails if two elements of the tree share one.
+
+using Clock = std::chrono::steady_clock;
+
+static void collect(const ui::Box& box, std::vector<const ui::Box*>& boxes) {
+    boxes.push_back(&box);
+    box.for_each_child([&](ui::Box& child) { collect(child, boxes); });
+}
+
+static bool equal(const gfx::Rect& a, const gfx::Rect& b) {
+    return a.x == b.x and a.y == b.y and a.width == b.width and a.height == b.height;
+}
+
+int main() {
+    gfx::Window window(800, 600, "transitions", gfx::WindowFlags());
+    ui::Ui ui(window);
+    ui.set_debug_output(false);
+
+    ui::Style style { .transition={ .duration=0.05f } };
+    float width = 10.0f;
+    auto moved = Clock::time_point::max();
+
+    window.draw_loop([&](gfx::Renderer& rd) {
+        ui.root(rd, [&](ui::Ui& ui) {
+            ui.horizontal([&] {
+                ui.box(width, 10.0f, style);
+                ui.box(20.0f, 10.0f, style);
+            });
+            ui.box(width, 10.0f, style);
+            ui.horizontal([&] {
+                ui.box(20.0f, 10.0f, style);
+                ui.box(width, 10.0f, style);
+                ui.box(20.0f, 10.0f, style);
+            });
+        }, style);
+
+        // the first frame only records the initial rects
+        if (moved == Clock::time_point::max()) {
+            width = 50.0f;
+            moved = Clock::now();
+        }
+
+        if (Clock::now() - moved > std::chrono::milliseconds(200))
+            window.close();
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+
+    std::vector<const ui::Box*> boxes;
+    collect(*ui.get_root(), boxes);
+
+    std::unordered_set<ui::Box::Id> ids;
+    for (const auto* box : boxes) {
+        if (not ids.insert(box->get_id()).second) {
+            std::println(stderr, "id {} is used by more than one element", box->get_id());
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const auto& rect = boxes[i]->get_rect();
+        const auto& visual = boxes[i]->get_visual_rect();
+
+        if (not equal(rect, visual)) {
+            std::println(stderr, "element {}: drawn at {} {} {} {}, expected {} {} {} {}", i,
+                         visual.x, visual.y, visual.width, visual.height,
+                         rect.x, rect.y, rect.width, rect.height);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::println("{} transitioned elements settled", boxes.size());
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <print>
+#include <optional>
 
 #include <gfx/gfx.h>
 
@@ -11,24 +12,30 @@ namespace ui {
 
 class TextInput : public Box {
 public:
-    TextInput(Id id, gfx::Window& window, gfx::Vec position, Style style, const gfx::Font& font, float width, std::string& text)
+    // see Label for why the text is measured by the caller
+    TextInput(Id id, gfx::Window& window, gfx::Vec position, Style style, const gfx::Font& font, float width, std::string& text, int text_width)
         : Box(id, window, position, style, 0.0f, 0.0f)
+        , m_fontsize(style.font_size)
         , m_text(text)
         , m_font(font)
     {
-        m_rect.width = std::max(static_cast<int>(width), m_font.measure_text(m_text, m_fontsize)) + m_style.padding * 2.0f;
+        m_rect.width = std::max(static_cast<int>(width), text_width) + m_style.padding * 2.0f;
         m_rect.height = m_fontsize + m_style.padding * 2.0f;
+        m_display_text = m_text;
+    }
 
+    ~TextInput() {
+        if (m_callback_id.has_value())
+            m_window.remove_char_callback(*m_callback_id);
+    }
+
+    void attach() override {
         m_callback_id = m_window.add_char_callback([&](std::string string, [[maybe_unused]] char32_t codepoint) {
             if (m_is_selected)
                 m_text.append(std::move(string));
         });
     }
 
-    ~TextInput() {
-        m_window.remove_char_callback(m_callback_id);
-    }
-
     [[nodiscard]] std::any export_state() const override {
         return m_is_selected;
     }
@@ -41,15 +48,20 @@ public:
         return m_is_selected;
     }
 
+    [[nodiscard]] bool captures_mouse() const override {
+        return is_hovered();
+    }
+
     void handle_input() override {
         handle_key_input();
         handle_selection_input();
+        m_display_text = m_text;
     }
 
     void draw(gfx::Renderer& rd) const override {
         Box::draw(rd);
         float padding = m_style.padding;
-        rd.draw_text(m_rect.x + padding, m_rect.y + padding, m_fontsize, m_text, m_font, m_style.color_text);
+        rd.draw_text(m_visual_rect.x + padding, m_visual_rect.y + padding, m_fontsize, m_display_text, m_font, m_style.color_text);
     }
 
     [[nodiscard]] std::string format() const override {
@@ -57,15 +69,18 @@ public:
     }
 
 protected:
-    const int m_fontsize = 50;
+    const int m_fontsize;
     std::string& m_text;
+    // the text as of building the tree, the referenced string might already
+    // be modified while this element is being drawn
+    std::string m_display_text;
     const gfx::Font& m_font;
-    gfx::Window::CallbackId m_callback_id;
+    std::optional<gfx::Window::CallbackId> m_callback_id;
     bool m_is_selected = false;
 
     void handle_key_input() {
 
-        auto key = m_window.get_key_state(gfx::Key::Backspace);
+        auto key = m_input->get_backspace();
 
         if (key.is_clicked() and m_is_selected)
             if (not m_text.empty())
@@ -73,9 +88,8 @@ protected:
     }
 
     void handle_selection_input() {
-        auto mouse = m_window.get_mouse_pos();
-        bool is_selected = m_rect.check_collision_point(mouse);
-        bool is_clicked = m_window.get_mouse_button_state(gfx::MouseButton::Left).is_clicked();
+        bool is_selected = is_hovered();
+        bool is_clicked = m_input->get_mouse_left().is_clicked();
 
         if (is_selected and is_clicked)
             m_is_selected = true;
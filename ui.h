@@ -1,16 +1,29 @@
 #pragma once
 
 #include <stack>
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <typeinfo>
+#include <optional>
+#include <unordered_map>
 #include <functional>
 
 #include <gfx/gfx.h>
 
+#include "animation.h"
 #include "box.h"
+#include "build_worker.h"
 #include "clickable.h"
 #include "button.h"
 #include "container.h"
+#include "font_manager.h"
+#include "fixed_block.h"
+#include "fixed_layout.h"
+#include "image.h"
+#include "image_cache.h"
+#include "input.h"
+#include "scroll_container.h"
 #include "label.h"
 #include "text_input.h"
 
@@ -43,24 +56,59 @@ private:
 class Ui {
 public:
     using Fn = std::function<void()>;
-
-    explicit Ui(gfx::Window& window)
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+        // the tree is built, laid out and drawn in the same call to root()
+        Immediate,
+        // the tree for the next frame is built on a persistent worker thread,
+        // while the tree of the previous frame is drawn. hover and press visuals are
+        // corrected with input sampled right before drawing. changes to the
+        // structure of the tree show up one frame later.
+        //
+        // the ui function must not access the window or renderer, and must
+        // not modify data referenced by elements of the previous frame, such
+        // as the text of labels.
+        Pipelined,
+    };
+
+    struct FrameStats {
+        Clock::duration build_time {};
+        Clock::duration draw_time {};
+        // time from sampling the input the drawn tree was built with, until
+        // all draw calls have been issued. one frame longer when pipelined.
+        Clock::duration structure_latency {};
+        // same, but for the input hover and press visuals are based on. equal
+        // to structure_latency, unless pipelined.
+        Clock::duration hover_latency {};
+    };
+
+    explicit Ui(gfx::Window& window, Mode mode=Mode::Immediate)
         : m_window(window)
-        , m_font(window.load_font("/usr/share/fonts/TTF/FiraCodeNerdFont-Regular.ttf"))
-    { }
+        , m_mode(mode)
+    {
+        FontManager::get().acquire();
+        ImageCache::get().acquire();
+    }
+
+    ~Ui() {
+        // elements refer to fonts and textures, so they go first
+        m_children.clear();
+        ImageCache::get().release();
+        FontManager::get().release();
+    }
 
-    ~Ui() = default;
     Ui(const Ui&) = delete;
     Ui(Ui&&) = delete;
     Ui& operator=(const Ui&) = delete;
     Ui& operator=(Ui&&) = delete;
 
     void label(std::string_view text, Style style={}) {
-        add_child<Label>(style, text, m_font);
+        add_child<Label>(style, text, get_font(), measure_text(text, style.font_size));
     }
 
     Clickable::State button(std::string_view text, Style style={}) {
-        return add_child<Button>(style, text, m_font).get_state();
+        return add_child<Button>(style, text, get_font(), measure_text(text, style.font_size)).get_state();
     }
 
     void box(float width, float height, Style style={}) {
@@ -68,9 +116,27 @@ public:
     }
 
     void text_input(float width, std::string& text, Style style={}) {
-        add_child<TextInput>(style, m_font, width, text);
+        add_child<TextInput>(style, get_font(), width, text, measure_text(text, style.font_size));
     }
 
+    // images are decoded in the background, the style's background color is
+    // shown until they are ready. the bytes of an EncodedImage are only
+    // referenced, they have to stay alive until the frame has been drawn.
+    void image(Image::Source source, float width, float height, Style style={}) {
+        add_child<Image>(style, std::move(source), width, height);
+    }
+
+    // emits a subtree which has been laid out at compile time. the layout
+    // has to outlive the frame, so it should be declared `static constexpr`.
+    template <size_t N>
+    void fixed_block(const fixed::Layout<N>& layout, std::span<const gfx::Color> palette) {
+        add_child<FixedBlock>({ .margin=layout.margin }, std::span(layout.commands), palette);
+    }
+
+    // the commands of a temporary layout would dangle before they are drawn
+    template <size_t N>
+    void fixed_block(const fixed::Layout<N>&& layout, std::span<const gfx::Color> palette) = delete;
+
     void horizontal(Fn fn, Style style={}) {
         container(fn, style, Container::Direction::Horizontal);
     }
@@ -79,27 +145,61 @@ public:
         container(fn, style, Container::Direction::Vertical);
     }
 
-    void root(gfx::Renderer& rd, std::function<void(Ui&)> fn, Style style={}) {
+    // a vertical container of a fixed size, which only shows the part of its
+    // children that is visible at `offset`
+    void scroll(float width, float height, gfx::Vec& offset, Fn fn, Style style={}) {
+        gfx::Rect viewport(m_axis.x + style.margin, m_axis.y + style.margin, width, height);
 
-        m_children = m_context.with_frame([&] {
-            vertical(std::bind(fn, std::ref(*this)), style);
-        });
+        auto saved_clip = m_clip;
+        auto saved_axis = m_axis;
+        auto saved_scroll = m_scroll;
 
-        if (m_children.empty()) return;
+        m_clip = intersect(m_clip, viewport);
+        m_axis.x -= offset.x;
+        m_axis.y -= offset.y;
+        m_scroll.x += offset.x;
+        m_scroll.y += offset.y;
 
-        assert(m_children.size() == 1);
-        auto& root = m_children.front();
+        auto children = build_children(fn, style, Container::Direction::Vertical);
 
-        root->debug();
-        root->draw(rd);
+        m_clip = saved_clip;
+        m_axis = saved_axis;
+        m_scroll = saved_scroll;
 
-        system("clear");
-        print_tree(*root, 0);
+        add_child<ScrollContainer>(style, std::move(children), width, height, offset);
+    }
 
-        save_state();
-        m_axis = gfx::Vec::zero();
-        m_parent_id = 0;
-        m_child_id = 1;
+    void root(gfx::Renderer& rd, std::function<void(Ui&)> fn, Style style={}) {
+        switch (m_mode) {
+            using enum Mode;
+            case Immediate: root_immediate(rd, fn, style); break;
+            case Pipelined: root_pipelined(rd, fn, style); break;
+        }
+    }
+
+    // input is sampled from the window, unless replaced, eg: by tests
+    void set_input_source(std::function<Input()> source) {
+        m_input_source = std::move(source);
+    }
+
+    // called with the root of every tree right after it has been drawn. when
+    // pipelined, this is the tree of the previous frame with its latched state.
+    void set_draw_callback(std::function<void(const Box&)> callback) {
+        m_draw_callback = std::move(callback);
+    }
+
+    // the ui tree is printed to the terminal every frame, unless disabled
+    void set_debug_output(bool enabled) {
+        m_debug_output = enabled;
+    }
+
+    [[nodiscard]] const FrameStats& get_frame_stats() const {
+        return m_frame_stats;
+    }
+
+    // the root container of the last frame, or nullptr before the first one
+    [[nodiscard]] const Box* get_root() const {
+        return m_children.empty() ? nullptr : m_children.front().get();
     }
 
     static void print_tree(const Box& box, int spacing) {
@@ -125,18 +225,242 @@ public:
 
 private:
     gfx::Window& m_window;
-    gfx::Font m_font;
+    const Mode m_mode;
+    bool m_debug_output = true;
+    const gfx::Font* m_font = nullptr; // owned by the FontManager
+
+    std::function<Input()> m_input_source;
+    std::function<void(const Box&)> m_draw_callback;
+
+    // the input the tree is built with. elements keep a pointer to it, so it
+    // is only replaced in place.
+    std::optional<Input> m_input;
+    FrameStats m_frame_stats;
 
     // we keep the ui tree around, so installed event handlers will still get called
     std::vector<std::unique_ptr<Box>> m_children;
 
     std::unordered_map<Box::Id, std::any> m_stored_state;
     Context m_context;
+    Animator m_animator;
+
+    struct TextKey {
+        std::string text;
+        int font_size;
+        bool operator==(const TextKey&) const = default;
+    };
+
+    struct TextKeyHash {
+        size_t operator()(const TextKey& key) const {
+            return std::hash<std::string>{}(key.text) ^ std::hash<int>{}(key.font_size);
+        }
+    };
+
+    // widths of the texts measured in this and in the previous frame, so
+    // unchanged texts do not have to wait for the render thread
+    std::unordered_map<TextKey, int, TextKeyHash> m_text_widths;
+    std::unordered_map<TextKey, int, TextKeyHash> m_prev_text_widths;
 
     gfx::Vec m_axis = gfx::Vec::zero();
+    gfx::Rect m_clip = unbounded_rect();
+    gfx::Vec m_scroll = gfx::Vec::zero();
     Container::Direction m_direction = Container::Direction::Vertical;
-    Box::Id m_parent_id = 0; // we use 0 here, because this makes the root id "01" and not "11"
-    Box::Id m_child_id = 1;
+    Box::Id m_parent_id = 0; // path id of the container being built, 0 for the root
+    Box::Id m_child_id = 1; // index of the next element within that container
+
+    // only created in pipelined mode, declared last so it is stopped first
+    std::optional<BuildWorker> m_worker;
+
+    [[nodiscard]] Input sample_input() const {
+        return m_input_source ? m_input_source() : Input::sample(m_window);
+    }
+
+    void root_immediate(gfx::Renderer& rd, std::function<void(Ui&)> fn, Style style) {
+        m_input.emplace(sample_input());
+
+        auto build_start = Clock::now();
+        m_children = build(fn, style);
+        m_frame_stats.build_time = Clock::now() - build_start;
+
+        if (m_children.empty()) return;
+
+        attach_rec(*m_children.front());
+
+        auto sample_time = m_input->get_sample_time();
+        present(rd, sample_time, sample_time);
+        print_debug_output();
+        finish_frame();
+    }
+
+    void root_pipelined(gfx::Renderer& rd, std::function<void(Ui&)> fn, Style style) {
+        if (not m_worker.has_value())
+            m_worker.emplace();
+
+        // the input the tree about to be drawn was built with
+        auto built_sample_time = m_input.has_value() ? m_input->get_sample_time() : Clock::time_point();
+        m_input.emplace(sample_input());
+
+        std::vector<std::unique_ptr<Box>> children;
+        Clock::duration build_time {};
+
+        m_worker->start([&] {
+            auto build_start = Clock::now();
+            children = build(fn, style);
+            build_time = Clock::now() - build_start;
+        });
+
+        bool has_drawn = not m_children.empty();
+
+        if (has_drawn) {
+            auto input = sample_input();
+            latch_input_rec(*m_children.front(), input);
+            present(rd, built_sample_time, input.get_sample_time());
+        }
+
+        // the worker might wait for the render thread to load fonts or
+        // measure text in the meantime
+        m_worker->wait();
+        m_frame_stats.build_time = build_time;
+
+        // the worker is idle now, so the drawn tree can be printed safely
+        if (has_drawn)
+            print_debug_output();
+
+        // the previous tree is destroyed here, on the render thread
+        m_children = std::move(children);
+        if (m_children.empty()) return;
+
+        attach_rec(*m_children.front());
+        finish_frame();
+    }
+
+    [[nodiscard]] auto build(std::function<void(Ui&)> fn, Style style) -> std::vector<std::unique_ptr<Box>> {
+        auto children = m_context.with_frame([&] {
+            vertical(std::bind(fn, std::ref(*this)), style);
+        });
+
+        assert(children.size() <= 1);
+        return children;
+    }
+
+    // structure_sample_time is when the input the tree was built with has been
+    // sampled, hover_sample_time the same for the input it has been latched with
+    void present(gfx::Renderer& rd, Clock::time_point structure_sample_time, Clock::time_point hover_sample_time) {
+        auto& root = m_children.front();
+        auto draw_start = Clock::now();
+
+        ImageCache::get().begin_frame();
+        m_animator.update();
+        animate_rec(*root);
+        m_animator.collect();
+
+        root->debug();
+        root->draw(rd);
+        ImageCache::get().end_frame();
+
+        auto draw_end = Clock::now();
+        m_frame_stats.draw_time = draw_end - draw_start;
+        m_frame_stats.structure_latency = draw_end - structure_sample_time;
+        m_frame_stats.hover_latency = draw_end - hover_sample_time;
+
+        if (m_draw_callback)
+            m_draw_callback(*root);
+    }
+
+    // prints the tree which has been drawn last, must not be called while it
+    // is being modified by the worker
+    void print_debug_output() const {
+        if (not m_debug_output) return;
+
+        system("clear");
+        print_tree(*m_children.front(), 0);
+        print_font_stats();
+        print_frame_stats();
+    }
+
+    void finish_frame() {
+        save_state();
+        m_prev_text_widths = std::move(m_text_widths);
+        m_text_widths.clear();
+        m_axis = gfx::Vec::zero();
+        m_clip = unbounded_rect();
+        m_scroll = gfx::Vec::zero();
+        m_parent_id = 0;
+        m_child_id = 1;
+    }
+
+    void attach_rec(Box& box) {
+        using namespace std::placeholders;
+
+        box.attach();
+        box.for_each_child(std::bind(&Ui::attach_rec, this, _1));
+    }
+
+    void latch_input_rec(Box& box, const Input& input) {
+        using namespace std::placeholders;
+
+        if (not box.is_visible()) return;
+
+        box.latch_input(input);
+        box.for_each_visible_child(std::bind(&Ui::latch_input_rec, this, _1, std::cref(input)));
+    }
+
+    void print_frame_stats() const {
+        using std::chrono::duration_cast, std::chrono::microseconds;
+
+        std::println("frame: build {}us, draw {}us, latency {}us (structure), {}us (hover)",
+                     duration_cast<microseconds>(m_frame_stats.build_time).count(),
+                     duration_cast<microseconds>(m_frame_stats.draw_time).count(),
+                     duration_cast<microseconds>(m_frame_stats.structure_latency).count(),
+                     duration_cast<microseconds>(m_frame_stats.hover_latency).count());
+    }
+
+    // runs fn on the render thread, as fonts own gpu resources
+    void on_render_thread(const std::function<void()>& fn) {
+        if (m_worker.has_value())
+            m_worker->run_on_render_thread(fn);
+        else
+            fn();
+    }
+
+    // fonts are only loaded once the first text element is created
+    [[nodiscard]] const gfx::Font& get_font() {
+        if (m_font == nullptr)
+            on_render_thread([&] { m_font = &FontManager::get().get_default_font(m_window); });
+
+        return *m_font;
+    }
+
+    [[nodiscard]] int measure_text(std::string_view text, int font_size) {
+        TextKey key { std::string(text), font_size };
+
+        if (auto it = m_text_widths.find(key); it != m_text_widths.end())
+            return it->second;
+
+        int width = 0;
+        if (auto it = m_prev_text_widths.find(key); it != m_prev_text_widths.end()) {
+            width = it->second;
+        } else {
+            const auto& font = get_font();
+            on_render_thread([&] { width = font.measure_text(text, font_size); });
+        }
+
+        m_text_widths.emplace(std::move(key), width);
+        return width;
+    }
+
+    static void print_font_stats() {
+        using std::chrono::duration_cast, std::chrono::microseconds;
+        auto stats = FontManager::get().get_stats();
+
+        // atlas memory is not exposed by gfx::Font, see FontManager::Stats
+        std::println("fonts: {} discovered in {}us, {} loaded in {}us ({} bytes of font files, atlas size unknown)",
+                     stats.discovered_fonts,
+                     duration_cast<microseconds>(stats.discovery_time).count(),
+                     stats.loaded_fonts,
+                     duration_cast<microseconds>(stats.load_time).count(),
+                     stats.font_file_bytes);
+    }
 
     void save_state() {
         m_stored_state.clear();
@@ -151,6 +475,15 @@ private:
         box.for_each_child(std::bind(&Ui::save_state_rec, this, _1));
     }
 
+    void animate_rec(Box& box) {
+        using namespace std::placeholders;
+
+        if (not box.is_visible()) return;
+
+        box.animate(m_animator);
+        box.for_each_visible_child(std::bind(&Ui::animate_rec, this, _1));
+    }
+
     void restore_state(Box& element) const {
         auto id = element.get_id();
 
@@ -158,20 +491,31 @@ private:
             element.apply_state(m_stored_state.at(id));
     }
 
-    // TODO: account for the type of widget, so we dont get std::bad_any_cast
-    [[nodiscard]] Box::Id generate_id() {
-        auto str = std::format("{}{}", m_parent_id, m_child_id);
-        Box::Id value;
-        std::from_chars<Box::Id>(str.c_str(), str.c_str()+str.size(), value);
-        return value;
+    // ids are derived from the path to the element and its type, so they stay
+    // the same across frames and state is never applied to a different widget
+    template <class Element>
+    [[nodiscard]] Box::Id generate_id() const {
+        return combine_ids(get_path_id(), typeid(Element).hash_code());
+    }
+
+    // identifies the position of the next element in the tree
+    [[nodiscard]] Box::Id get_path_id() const {
+        return combine_ids(m_parent_id, m_child_id);
+    }
+
+    [[nodiscard]] static Box::Id combine_ids(Box::Id seed, Box::Id value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
     }
 
     template <class Element, typename... Args> requires std::is_base_of_v<Box, Element>
     Element& add_child(Style style, Args&&... args) {
 
         gfx::Vec pos(m_axis.x + style.margin, m_axis.y + style.margin);
-        auto element = std::make_unique<Element>(generate_id(), m_window, pos, style, std::forward<Args>(args)...);
+        auto element = std::make_unique<Element>(generate_id<Element>(), m_window, pos, style, std::forward<Args>(args)...);
 
+        element->set_clip_rect(m_clip);
+        element->set_scroll_offset(m_scroll);
+        element->set_input(*m_input);
         restore_state(*element);
 
         switch (m_direction) {
@@ -190,11 +534,20 @@ private:
         m_context.add_element(std::move(element));
 
         m_child_id++;
-        element_ref.handle_input();
+
+        if (element_ref.is_visible())
+            element_ref.handle_input();
+
         return element_ref;
     }
 
     void container(Fn fn, Style style, Container::Direction direction) {
+        auto children = build_children(fn, style, direction);
+        add_child<Container>(style, std::move(children), direction);
+    }
+
+    // invoke fn in a new frame, laying out its elements in the given direction
+    auto build_children(Fn fn, Style style, Container::Direction direction) -> std::vector<std::unique_ptr<Box>> {
 
         auto saved_direction = m_direction;
         auto saved_axis = m_axis;
@@ -203,18 +556,21 @@ private:
         m_axis.x += style.padding;
         m_axis.y += style.padding;
 
-        auto old_parent_id = m_parent_id;
-        m_parent_id = m_child_id;
+        // the container is added after its children, at the current position
+        auto saved_parent_id = m_parent_id;
+        auto saved_child_id = m_child_id;
+        m_parent_id = get_path_id();
+        m_child_id = 1;
 
         auto children = m_context.with_frame(fn);
 
-        m_parent_id = old_parent_id;
-        m_child_id = 1;
+        m_parent_id = saved_parent_id;
+        m_child_id = saved_child_id;
 
         m_axis = saved_axis;
         m_direction = saved_direction;
 
-        add_child<Container>(style, std::move(children), direction);
+        return children;
     }
 
 };